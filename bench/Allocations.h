@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace mms {
+
+class Allocations {
+
+public:
+
+    // The Allocations class is not constructible
+    Allocations() = delete;
+
+    // The number of heap allocations made so far by any thread. With glibc,
+    // this counts every call to malloc, including the ones that Qt containers
+    // make directly; elsewhere, it only counts calls to operator new.
+    static qint64 count();
+
+};
+
+}
@@ -0,0 +1,451 @@
+#include <QByteArray>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QVector>
+
+#include <cmath>
+#include <functional>
+#include <list>
+
+#include "Allocations.h"
+#include "AssertMacros.h"
+#include "BufferInterface.h"
+#include "CommandParser.h"
+#include "Dimensions.h"
+#include "Maze.h"
+#include "MazeChecker.h"
+#include "MazeGenerator.h"
+#include "MazeGraphic.h"
+#include "MazeView.h"
+#include "Polygon.h"
+#include "RayCaster.h"
+#include "TileGeometry.h"
+#include "polypartition/polypartition.h"
+
+namespace mms {
+
+// Each benchmark runs repeatedly until it has taken at least this long
+static const qint64 MIN_BENCHMARK_NANOSECONDS = 200 * 1000 * 1000;
+
+static QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+struct Measurement {
+    double nanoseconds;
+    double allocations;
+};
+
+// Runs the function until enough time has passed, returns the averages per run
+static Measurement measure(const std::function<void()>& function) {
+    qint64 allocations = Allocations::count();
+    QElapsedTimer timer;
+    timer.start();
+    qint64 runs = 0;
+    while (timer.nsecsElapsed() < MIN_BENCHMARK_NANOSECONDS) {
+        function();
+        runs += 1;
+    }
+    qint64 nanoseconds = timer.nsecsElapsed();
+    allocations = Allocations::count() - allocations;
+    return {
+        static_cast<double>(nanoseconds) / runs,
+        static_cast<double>(allocations) / runs,
+    };
+}
+
+static void report(const QString& name, const Measurement& measurement) {
+    out() << name.leftJustified(48)
+          << QString::number(measurement.nanoseconds, 'f', 0).rightJustified(14)
+          << " ns/op"
+          << QString::number(measurement.allocations, 'f', 1).rightJustified(14)
+          << " allocs/op" << endl;
+}
+
+// The triangulation that every polygon used to go through, kept here as the
+// baseline that the Polygon fast path and cache are compared against
+static QVector<Triangle> triangulateEarClipping(const QVector<Coordinate>& vertices) {
+    TPPLPoly tpplPoly;
+    tpplPoly.Init(vertices.size());
+    for (int i = 0; i < vertices.size(); i += 1) {
+        tpplPoly[i].x = vertices.at(i).getX().getMeters();
+        tpplPoly[i].y = vertices.at(i).getY().getMeters();
+    }
+    tpplPoly.SetOrientation(TPPL_CCW);
+    TPPLPartition triangulator;
+    std::list<TPPLPoly> result;
+    triangulator.Triangulate_EC(&tpplPoly, &result);
+    QVector<Triangle> triangles;
+    for (auto it = result.begin(); it != result.end(); it++) {
+        triangles.append({
+            Coordinate::Cartesian(Distance::Meters((*it)[0].x), Distance::Meters((*it)[0].y)),
+            Coordinate::Cartesian(Distance::Meters((*it)[1].x), Distance::Meters((*it)[1].y)),
+            Coordinate::Cartesian(Distance::Meters((*it)[2].x), Distance::Meters((*it)[2].y)),
+        });
+    }
+    return triangles;
+}
+
+static QVector<Coordinate> toVertices(const QPair<Coordinate, Coordinate>& rectangle) {
+    return {
+        rectangle.first,
+        Coordinate::Cartesian(rectangle.first.getX(), rectangle.second.getY()),
+        rectangle.second,
+        Coordinate::Cartesian(rectangle.second.getX(), rectangle.first.getY()),
+    };
+}
+
+// The polygons that each tile used to own: full, interior, walls, corners
+static QVector<QVector<Coordinate>> getTilePolygons(int x, int y, int width, int height) {
+    QVector<QVector<Coordinate>> polygons;
+    polygons.append(toVertices(TileGeometry::getFullRectangle(x, y, width, height)));
+    polygons.append(toVertices(TileGeometry::getInteriorRectangle(x, y, width, height)));
+    for (Direction direction : DIRECTIONS()) {
+        polygons.append(toVertices(
+            TileGeometry::getWallRectangle(x, y, width, height, direction)));
+    }
+    for (int cornerNumber = 0; cornerNumber < 4; cornerNumber += 1) {
+        polygons.append(toVertices(
+            TileGeometry::getCornerRectangle(x, y, width, height, cornerNumber)));
+    }
+    return polygons;
+}
+
+static void benchmarkTriangulation() {
+
+    QVector<Coordinate> rectangle = toVertices({
+        Coordinate::Cartesian(Distance::Meters(0.0), Distance::Meters(0.0)),
+        Coordinate::Cartesian(Distance::Meters(0.1), Distance::Meters(0.2)),
+    });
+    QVector<Coordinate> concave = {
+        Coordinate::Cartesian(Distance::Meters(0.0), Distance::Meters(0.0)),
+        Coordinate::Cartesian(Distance::Meters(0.0), Distance::Meters(0.2)),
+        Coordinate::Cartesian(Distance::Meters(0.1), Distance::Meters(0.2)),
+        Coordinate::Cartesian(Distance::Meters(0.1), Distance::Meters(0.1)),
+        Coordinate::Cartesian(Distance::Meters(0.2), Distance::Meters(0.1)),
+        Coordinate::Cartesian(Distance::Meters(0.2), Distance::Meters(0.0)),
+    };
+
+    report("triangulate/rectangle/ear-clipping", measure([&]() {
+        triangulateEarClipping(rectangle);
+    }));
+    report("triangulate/rectangle/polygon", measure([&]() {
+        Polygon(rectangle).getTriangles();
+    }));
+    report("triangulate/concave/ear-clipping", measure([&]() {
+        triangulateEarClipping(concave);
+    }));
+    report("triangulate/concave/polygon", measure([&]() {
+        Polygon(concave).getTriangles();
+    }));
+}
+
+static void benchmarkMazeConstruction(int size) {
+
+    WallGrid grid = MazeGenerator::generate(MazeGeneratorType::TOMASZ, size, size, 0);
+    QString prefix = QString("maze/%1x%1/").arg(size);
+
+    // What Maze construction used to do: build and triangulate every polygon
+    // of every tile up front
+    report(prefix + "polygons/ear-clipping", measure([&]() {
+        for (int x = 0; x < size; x += 1) {
+            for (int y = 0; y < size; y += 1) {
+                for (const QVector<Coordinate>& vertices : getTilePolygons(x, y, size, size)) {
+                    triangulateEarClipping(vertices);
+                }
+            }
+        }
+    }));
+
+    // The same, but through the Polygon fast path
+    report(prefix + "polygons/polygon", measure([&]() {
+        for (int x = 0; x < size; x += 1) {
+            for (int y = 0; y < size; y += 1) {
+                for (const QVector<Coordinate>& vertices : getTilePolygons(x, y, size, size)) {
+                    Polygon(vertices).getTriangles();
+                }
+            }
+        }
+    }));
+
+    // What Maze construction does now, including the buffers for drawing it
+    report(prefix + "maze", measure([&]() {
+        delete Maze::fromWallGrid(grid);
+    }));
+    report(prefix + "maze+view", measure([&]() {
+        Maze* maze = Maze::fromWallGrid(grid);
+        delete new MazeView(maze);
+        delete maze;
+    }));
+}
+
+
+// The formats that Maze::fromFile reads, see Maze::fromMapFile and fromNumFile
+static QStringList toMapLines(const WallGrid& grid) {
+    QStringList lines;
+    auto horizontal = [&](int y, Direction direction) {
+        QString line = "+";
+        for (int x = 0; x < grid.getWidth(); x += 1) {
+            line += grid.isWall(x, y, direction) ? "---+" : "   +";
+        }
+        return line;
+    };
+    for (int y = grid.getHeight() - 1; 0 <= y; y -= 1) {
+        lines.append(horizontal(y, Direction::NORTH));
+        QString line;
+        for (int x = 0; x < grid.getWidth(); x += 1) {
+            line += grid.isWall(x, y, Direction::WEST) ? "|   " : "    ";
+        }
+        line += grid.isWall(grid.getWidth() - 1, y, Direction::EAST) ? "|" : " ";
+        lines.append(line);
+    }
+    lines.append(horizontal(0, Direction::SOUTH));
+    return lines;
+}
+
+static QStringList toNumLines(const WallGrid& grid) {
+    QStringList lines;
+    for (int x = 0; x < grid.getWidth(); x += 1) {
+        for (int y = 0; y < grid.getHeight(); y += 1) {
+            QString line = QString("%1 %2").arg(x).arg(y);
+            for (Direction direction : DIRECTIONS()) {
+                line += grid.isWall(x, y, direction) ? " 1" : " 0";
+            }
+            lines.append(line);
+        }
+    }
+    return lines;
+}
+
+static QString writeLines(const QString& path, const QStringList& lines) {
+    QFile file(path);
+    file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    QTextStream stream(&file);
+    for (const QString& line : lines) {
+        stream << line << "\n";
+    }
+    return path;
+}
+
+static void benchmarkMazeFiles(const QTemporaryDir& directory, int size) {
+
+    WallGrid grid = MazeGenerator::generate(MazeGeneratorType::TOMASZ, size, size, 0);
+    QString prefix = QString("maze/%1x%1/").arg(size);
+
+    QString mapPath = writeLines(
+        QDir(directory.path()).filePath(QString("%1.map").arg(size)),
+        toMapLines(grid));
+    QString numPath = writeLines(
+        QDir(directory.path()).filePath(QString("%1.num").arg(size)),
+        toNumLines(grid));
+    for (const QString& path : {mapPath, numPath}) {
+        Maze* maze = Maze::fromFile(path);
+        ASSERT_FA(maze == nullptr);
+        delete maze;
+    }
+
+    report(prefix + "fromFile/map", measure([&]() {
+        delete Maze::fromFile(mapPath);
+    }));
+    report(prefix + "fromFile/num", measure([&]() {
+        delete Maze::fromFile(numPath);
+    }));
+    report(prefix + "isValid", measure([&]() {
+        MazeChecker::isValid(grid);
+    }));
+    report(prefix + "getDistances", measure([&]() {
+        Maze::getDistances(grid);
+    }));
+    Maze* maze = Maze::fromWallGrid(grid);
+    report(prefix + "mazeView", measure([&]() {
+        delete new MazeView(maze);
+    }));
+    delete maze;
+}
+
+static void benchmarkGraphicUpdates() {
+
+    int size = 16;
+    Maze* maze = Maze::fromWallGrid(
+        MazeGenerator::generate(MazeGeneratorType::TOMASZ, size, size, 0));
+
+    // The same setup that MazeView does, but with access to each layer
+    QVector<TriangleGraphic> graphicCpuBuffer;
+    QVector<TriangleTexture> textureCpuBuffer;
+    BufferInterface bufferInterface(
+        {size, size}, &graphicCpuBuffer, &textureCpuBuffer);
+    bufferInterface.initTileGraphicText(
+        Dimensions::wallLength(), Dimensions::wallWidth(), {2, 5});
+    MazeGraphic mazeGraphic(maze, &bufferInterface);
+    mazeGraphic.drawPolygons();
+    mazeGraphic.drawTextures();
+
+    // Alternate the state on each pass over the tiles, so that every update
+    // actually changes the tile
+    int i = 0;
+    int pass = 0;
+    auto next = [&]() {
+        i = (i + 1) % (size * size);
+        pass += i == 0 ? 1 : 0;
+    };
+
+    report("bufferInterface/updateTileGraphicBaseColor", measure([&]() {
+        bufferInterface.updateTileGraphicBaseColor(
+            i / size, i % size, Color::BLUE);
+        next();
+    }));
+    report("bufferInterface/updateTileGraphicWallColor", measure([&]() {
+        bufferInterface.updateTileGraphicWallColor(
+            i / size, i % size, Direction::NORTH, Color::RED, 255);
+        next();
+    }));
+    report("bufferInterface/updateTileGraphicText", measure([&]() {
+        bufferInterface.updateTileGraphicText(
+            i / size, i % size, 2, 5, 1, 2, 'A');
+        next();
+    }));
+
+    // Goes through TileGraphic::updateText; each update is flushed on its
+    // own, as if every frame had just the one update
+    QStringList texts = {"", "7", "123", "abcdefghij", "too long to fit"};
+    report("tileGraphic/setText", measure([&]() {
+        mazeGraphic.setText(
+            i / size, i % size, texts.at((i + pass) % texts.size()));
+        mazeGraphic.flush();
+        next();
+    }));
+    report("tileGraphic/setColor", measure([&]() {
+        mazeGraphic.setColor(
+            i / size, i % size, pass % 2 == 0 ? Color::GREEN : Color::BLUE);
+        mazeGraphic.flush();
+        next();
+    }));
+    report("tileGraphic/setWall", measure([&]() {
+        if (pass % 2 == 0) {
+            mazeGraphic.setWall(i / size, i % size, Direction::EAST);
+        }
+        else {
+            mazeGraphic.clearWall(i / size, i % size, Direction::EAST);
+        }
+        mazeGraphic.flush();
+        next();
+    }));
+
+    // An algorithm that redraws everything several times per frame; only
+    // the last state of each tile reaches the buffers
+    report("mazeGraphic/redrawTenTimesPerFrame", measure([&]() {
+        for (int j = 0; j < 10; j += 1) {
+            for (int k = 0; k < size * size; k += 1) {
+                mazeGraphic.setColor(
+                    k / size,
+                    k % size,
+                    (j + pass) % 2 == 0 ? Color::GREEN : Color::BLUE);
+                mazeGraphic.setText(k / size, k % size, texts.at(j % texts.size()));
+            }
+        }
+        mazeGraphic.flush();
+        pass += 1;
+    }));
+
+    delete maze;
+}
+
+// A fan of rays from the center of the starting tile, long enough to cross
+// the whole maze, both one at a time and all at once
+static void benchmarkRayCasting(int size) {
+
+    WallGrid grid = MazeGenerator::generate(MazeGeneratorType::TOMASZ, size, size, 0);
+    QString prefix = QString("rayCaster/%1x%1/").arg(size);
+    double halfTileLength = Dimensions::halfTileLength().getMeters();
+    double length = Dimensions::tileLength().getMeters() * size * 2;
+    QVector<RayCaster::Ray> rays;
+    for (int i = 0; i < 64; i += 1) {
+        double angle = M_PI / 2 * i / 64;
+        rays.append({
+            halfTileLength,
+            halfTileLength,
+            std::cos(angle),
+            std::sin(angle),
+            length,
+        });
+    }
+
+    report(prefix + "single", measure([&]() {
+        for (const RayCaster::Ray& ray : rays) {
+            RayCaster::cast(grid, ray);
+        }
+    }));
+    report(prefix + "batch", measure([&]() {
+        RayCaster::cast(grid, rays);
+    }));
+}
+
+static void benchmarkCommandParsing() {
+    QVector<QPair<QString, QByteArray>> commands = {
+        {"mazeWidth", "mazeWidth"},
+        {"wallFront", "wallFront"},
+        {"moveForward", "moveForward"},
+        {"turnRight", "turnRight"},
+        {"setWall", "setWall 12 3 n"},
+        {"clearWall", "clearWall 12 3 e"},
+        {"setColor", "setColor 12 3 G"},
+        {"clearColor", "clearColor 12 3"},
+        {"clearAllColor", "clearAllColor"},
+        {"setText", "setText 12 3 hello world"},
+        {"clearText", "clearText 12 3"},
+        {"clearAllText", "clearAllText"},
+        {"invalid", "setWall 12 x"},
+    };
+    for (const auto& pair : commands) {
+        report("commandParser/" + pair.first, measure([&]() {
+            CommandParser::parse(pair.second);
+        }));
+    }
+}
+
+static void benchmarkPolygonTransforms() {
+    Polygon polygon({
+        Coordinate::Cartesian(Distance::Meters(0.0), Distance::Meters(0.0)),
+        Coordinate::Cartesian(Distance::Meters(0.0), Distance::Meters(0.2)),
+        Coordinate::Cartesian(Distance::Meters(0.1), Distance::Meters(0.2)),
+        Coordinate::Cartesian(Distance::Meters(0.1), Distance::Meters(0.1)),
+        Coordinate::Cartesian(Distance::Meters(0.2), Distance::Meters(0.1)),
+        Coordinate::Cartesian(Distance::Meters(0.2), Distance::Meters(0.0)),
+    });
+    polygon.getTriangles();
+    Polygon output;
+    Coordinate translation = Coordinate::Cartesian(
+        Distance::Meters(0.3), Distance::Meters(0.4));
+    report("polygon/translate", measure([&]() {
+        polygon.translate(translation, &output);
+    }));
+    report("polygon/rotateAroundPoint", measure([&]() {
+        polygon.rotateAroundPoint(Angle::Degrees(30), translation, &output);
+    }));
+}
+
+}
+
+int main() {
+    mms::benchmarkTriangulation();
+    mms::benchmarkPolygonTransforms();
+    for (int size : {16, 64, 256}) {
+        mms::benchmarkMazeConstruction(size);
+    }
+    QTemporaryDir directory;
+    for (int size : {16, 32, 128, 512}) {
+        mms::benchmarkMazeFiles(directory, size);
+    }
+    for (int size : {16, 256}) {
+        mms::benchmarkRayCasting(size);
+    }
+    mms::benchmarkGraphicUpdates();
+    mms::benchmarkCommandParsing();
+    return 0;
+}
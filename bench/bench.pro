@@ -0,0 +1,46 @@
+QT += core
+QT -= gui
+
+TEMPLATE = app
+TARGET = mms-bench
+
+CONFIG += c++11
+CONFIG += console
+CONFIG += object_parallel_to_source
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../src
+
+SOURCES += $$files(*.cpp)
+HEADERS += $$files(*.h)
+
+# The parts of the simulator that the benchmarks exercise
+SOURCES += \
+    ../src/BufferInterface.cpp \
+    ../src/Color.cpp \
+    ../src/ColorManager.cpp \
+    ../src/CommandParser.cpp \
+    ../src/Dimensions.cpp \
+    ../src/Direction.cpp \
+    ../src/FontImage.cpp \
+    ../src/GeometryUtilities.cpp \
+    ../src/Maze.cpp \
+    ../src/MazeChecker.cpp \
+    ../src/MazeGenerator.cpp \
+    ../src/MazeGraphic.cpp \
+    ../src/MazeView.cpp \
+    ../src/Polygon.cpp \
+    ../src/RayCaster.cpp \
+    ../src/TileGeometry.cpp \
+    ../src/TileGraphic.cpp \
+    ../src/TileGraphicTextCache.cpp \
+    ../src/Trace.cpp \
+    ../src/WallGrid.cpp \
+    ../src/polypartition/polypartition.cpp \
+    ../src/units/Angle.cpp \
+    ../src/units/Coordinate.cpp \
+    ../src/units/Distance.cpp
+
+DESTDIR     = ../bin
+MOC_DIR     = ../build/bench/moc
+OBJECTS_DIR = ../build/bench/obj
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+// A synthetic mouse algorithm that speaks the simulator's protocol over stdin
+// and stdout, like any other algorithm, and reports its throughput and the
+// round-trip latency of its requests on stderr when it's done.
+//
+//     mms-client query|visualization|floodfill [iterations]
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+long long g_commands = 0;
+std::vector<double> g_latencies;
+
+// Commands without a response
+void send(const std::string& command) {
+    std::cout << command << '\n';
+    g_commands += 1;
+}
+
+// Commands with a response, which also flush everything sent before them
+std::string request(const std::string& command) {
+    Clock::time_point start = Clock::now();
+    std::cout << command << std::endl;
+    std::string response;
+    std::getline(std::cin, response);
+    g_latencies.push_back(
+        std::chrono::duration<double, std::micro>(Clock::now() - start).count()
+    );
+    g_commands += 1;
+    return response;
+}
+
+int mazeWidth() {
+    return std::atoi(request("mazeWidth").c_str());
+}
+
+int mazeHeight() {
+    return std::atoi(request("mazeHeight").c_str());
+}
+
+bool wallFront() {
+    return request("wallFront") == "true";
+}
+
+bool wallRight() {
+    return request("wallRight") == "true";
+}
+
+bool wallLeft() {
+    return request("wallLeft") == "true";
+}
+
+bool moveForward() {
+    return request("moveForward") == "ack";
+}
+
+void turnRight() {
+    request("turnRight");
+}
+
+void turnLeft() {
+    request("turnLeft");
+}
+
+void setWall(int x, int y, char direction) {
+    send("setWall " + std::to_string(x) + " " + std::to_string(y) + " " + direction);
+}
+
+void setColor(int x, int y, char color) {
+    send("setColor " + std::to_string(x) + " " + std::to_string(y) + " " + color);
+}
+
+void setText(int x, int y, const std::string& text) {
+    send("setText " + std::to_string(x) + " " + std::to_string(y) + " " + text);
+}
+
+// A pure query storm: the cheapest possible round trips
+void runQuery(int iterations) {
+    for (int i = 0; i < iterations; i += 1) {
+        wallFront();
+    }
+}
+
+// Redraws the whole grid every step, like an algorithm that visualizes its
+// entire state after each move
+void runVisualization(int iterations) {
+    static const std::string colors = "rgbcyow";
+    int width = mazeWidth();
+    int height = mazeHeight();
+    for (int i = 0; i < iterations; i += 1) {
+        for (int x = 0; x < width; x += 1) {
+            for (int y = 0; y < height; y += 1) {
+                setColor(x, y, colors[(x + y + i) % colors.size()]);
+                setText(x, y, std::to_string(i));
+            }
+        }
+        wallFront();
+    }
+}
+
+// The classic flood fill: repeatedly move to the neighbor closest to the
+// center, given the walls discovered so far, redrawing the distances as
+// they change. Each iteration is one trip from the start to the center.
+void runFloodfill(int iterations) {
+
+    // Directions are north, east, south, west
+    static const int dx[] = {0, 1, 0, -1};
+    static const int dy[] = {1, 0, -1, 0};
+    static const char names[] = {'n', 'e', 's', 'w'};
+
+    int width = mazeWidth();
+    int height = mazeHeight();
+    std::vector<unsigned char> walls(width * height, 0);
+    std::vector<int> distances(width * height, 0);
+    auto index = [&](int x, int y) { return height * x + y; };
+    auto addWall = [&](int x, int y, int d) {
+        walls[index(x, y)] |= 1 << d;
+        int nx = x + dx[d];
+        int ny = y + dy[d];
+        if (0 <= nx && nx < width && 0 <= ny && ny < height) {
+            walls[index(nx, ny)] |= 1 << ((d + 2) % 4);
+        }
+    };
+    auto isGoal = [&](int x, int y) {
+        return (
+            (x == (width - 1) / 2 || x == width / 2) &&
+            (y == (height - 1) / 2 || y == height / 2)
+        );
+    };
+    auto flood = [&]() {
+        std::vector<int> previous = distances;
+        std::fill(distances.begin(), distances.end(), -1);
+        std::queue<int> queue;
+        for (int x = 0; x < width; x += 1) {
+            for (int y = 0; y < height; y += 1) {
+                if (isGoal(x, y)) {
+                    distances[index(x, y)] = 0;
+                    queue.push(index(x, y));
+                }
+            }
+        }
+        while (!queue.empty()) {
+            int current = queue.front();
+            queue.pop();
+            int x = current / height;
+            int y = current % height;
+            for (int d = 0; d < 4; d += 1) {
+                int nx = x + dx[d];
+                int ny = y + dy[d];
+                if (
+                    !(walls[current] & (1 << d)) &&
+                    0 <= nx && nx < width && 0 <= ny && ny < height &&
+                    distances[index(nx, ny)] == -1
+                ) {
+                    distances[index(nx, ny)] = distances[current] + 1;
+                    queue.push(index(nx, ny));
+                }
+            }
+        }
+        for (int i = 0; i < width * height; i += 1) {
+            if (distances[i] != previous[i]) {
+                setText(i / height, i % height, std::to_string(distances[i]));
+            }
+        }
+    };
+
+    int x = 0;
+    int y = 0;
+    int direction = 0;
+    for (int i = 0; i < iterations; i += 1) {
+        while (!isGoal(x, y)) {
+            setColor(x, y, 'c');
+            if (wallFront()) {
+                addWall(x, y, direction);
+                setWall(x, y, names[direction]);
+            }
+            if (wallRight()) {
+                addWall(x, y, (direction + 1) % 4);
+                setWall(x, y, names[(direction + 1) % 4]);
+            }
+            if (wallLeft()) {
+                addWall(x, y, (direction + 3) % 4);
+                setWall(x, y, names[(direction + 3) % 4]);
+            }
+            flood();
+
+            // Pick the open neighbor with the smallest distance
+            int best = -1;
+            for (int d = 0; d < 4; d += 1) {
+                int nx = x + dx[d];
+                int ny = y + dy[d];
+                if (
+                    !(walls[index(x, y)] & (1 << d)) &&
+                    0 <= nx && nx < width && 0 <= ny && ny < height &&
+                    0 <= distances[index(nx, ny)] && (
+                        best == -1 ||
+                        distances[index(nx, ny)] <
+                        distances[index(x + dx[best], y + dy[best])]
+                    )
+                ) {
+                    best = d;
+                }
+            }
+            if (best == -1) {
+                return;
+            }
+
+            // Turn to face it, then move
+            if (best == (direction + 1) % 4) {
+                turnRight();
+            }
+            else if (best == (direction + 3) % 4) {
+                turnLeft();
+            }
+            else if (best == (direction + 2) % 4) {
+                turnRight();
+                turnRight();
+            }
+            direction = best;
+            if (!moveForward()) {
+                return;
+            }
+            x += dx[direction];
+            y += dy[direction];
+        }
+
+        // Start over from the beginning, keeping the discovered walls
+        request("ackReset");
+        x = 0;
+        y = 0;
+        direction = 0;
+    }
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t i = static_cast<size_t>(fraction * (values.size() - 1));
+    return values.at(i);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+
+    std::ios::sync_with_stdio(false);
+    std::string workload = 1 < argc ? argv[1] : "query";
+    int iterations = 2 < argc ? std::atoi(argv[2]) : 10000;
+
+    Clock::time_point start = Clock::now();
+    if (workload == "query") {
+        runQuery(iterations);
+    }
+    else if (workload == "visualization") {
+        runVisualization(iterations);
+    }
+    else if (workload == "floodfill") {
+        runFloodfill(iterations);
+    }
+    else {
+        std::cerr << "Unknown workload: " << workload << std::endl;
+        return 1;
+    }
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cerr
+        << workload << ": "
+        << g_commands << " commands in " << seconds << " s, "
+        << static_cast<long long>(g_commands / seconds) << " commands/s, "
+        << "round trip p50 " << percentile(g_latencies, 0.50) << " us, "
+        << "p99 " << percentile(g_latencies, 0.99) << " us"
+        << std::endl;
+    return 0;
+}
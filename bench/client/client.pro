@@ -0,0 +1,12 @@
+TEMPLATE = app
+TARGET = mms-client
+
+CONFIG += c++11
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+SOURCES += Main.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../build/client/obj
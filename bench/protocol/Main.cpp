@@ -0,0 +1,308 @@
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QPair>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include "Color.h"
+#include "CommandDispatcher.h"
+#include "CommandParser.h"
+#include "Dimensions.h"
+#include "Direction.h"
+#include "Maze.h"
+#include "MazeGenerator.h"
+#include "MazeView.h"
+#include "Mouse.h"
+#include "ProcessUtilities.h"
+#include "World.h"
+
+// Runs the synthetic client (mms-client) against a headless simulator, through
+// the same ProcessUtilities::start and QProcess path, and the same
+// CommandParser and CommandDispatcher, that Window uses. There's no window, so
+// movements complete instantly, and visualization commands only update the
+// CPU-side buffers; everything else is the real protocol, including the
+// wheels and sensors of the continuous simulation.
+//
+//     mms-protocol-bench [maze size]
+
+namespace mms {
+
+static QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// The mouse of the benchmark, which stands in for Window::RunMouse
+class BenchMouse : public MouseInterface {
+
+public:
+
+    explicit BenchMouse(const Maze* maze) :
+        m_maze(maze),
+        m_view(maze),
+        m_x(0),
+        m_y(0),
+        m_direction(Direction::NORTH),
+        m_world(nullptr) {
+    }
+
+    ~BenchMouse() {
+        delete m_world;
+    }
+
+    MazeGraphic* getMazeGraphic() {
+        return m_view.getMazeGraphic();
+    }
+
+    int mazeWidth() override {
+        return m_maze->getWidth();
+    }
+
+    int mazeHeight() override {
+        return m_maze->getHeight();
+    }
+
+    bool wallFront() override {
+        return m_maze->isWall(m_x, m_y, m_direction);
+    }
+
+    bool wallRight() override {
+        return m_maze->isWall(
+            m_x, m_y, DIRECTION_ROTATE_RIGHT().value(m_direction));
+    }
+
+    bool wallLeft() override {
+        return m_maze->isWall(
+            m_x, m_y, DIRECTION_ROTATE_LEFT().value(m_direction));
+    }
+
+    QString moveForward() override {
+        if (m_world != nullptr) {
+            return CommandDispatcher::ON_WHEELS;
+        }
+        if (wallFront()) {
+            return CommandDispatcher::CRASH;
+        }
+        m_x += m_direction == Direction::EAST ? 1 : 0;
+        m_x -= m_direction == Direction::WEST ? 1 : 0;
+        m_y += m_direction == Direction::NORTH ? 1 : 0;
+        m_y -= m_direction == Direction::SOUTH ? 1 : 0;
+        return CommandDispatcher::ACK;
+    }
+
+    QString turnRight() override {
+        if (m_world != nullptr) {
+            return CommandDispatcher::ON_WHEELS;
+        }
+        m_direction = DIRECTION_ROTATE_RIGHT().value(m_direction);
+        return CommandDispatcher::ACK;
+    }
+
+    QString turnLeft() override {
+        if (m_world != nullptr) {
+            return CommandDispatcher::ON_WHEELS;
+        }
+        m_direction = DIRECTION_ROTATE_LEFT().value(m_direction);
+        return CommandDispatcher::ACK;
+    }
+
+    void setWheelSpeeds(int left, int right) override {
+        if (m_world == nullptr) {
+            // The world takes over from the tile that the mouse moved to
+            Distance tileLength = Dimensions::tileLength();
+            m_mouse.teleport(
+                Coordinate::Cartesian(
+                    tileLength * (static_cast<double>(m_x) + 0.5),
+                    tileLength * (static_cast<double>(m_y) + 0.5)),
+                DIRECTION_TO_ANGLE().value(m_direction));
+            m_world = new World(m_maze, &m_mouse);
+        }
+        m_world->setWheelSpeeds(
+            Angle::Degrees(left).getRadiansUnbounded(),
+            Angle::Degrees(right).getRadiansUnbounded());
+    }
+
+    QPair<int, int> readEncoders() override {
+        if (m_world == nullptr) {
+            return {0, 0};
+        }
+        return m_world->readEncoders();
+    }
+
+    QVector<double> readSensors() override {
+        if (m_world == nullptr) {
+            return QVector<double>(World::NUM_SENSORS, 0.0);
+        }
+        return m_world->readSensors();
+    }
+
+    void setWall(int x, int y, QChar direction) override {
+        if (isWithinMaze(x, y)) {
+            getMazeGraphic()->setWall(
+                x, y, CHAR_TO_DIRECTION().value(direction));
+        }
+    }
+
+    void clearWall(int x, int y, QChar direction) override {
+        if (isWithinMaze(x, y)) {
+            getMazeGraphic()->clearWall(
+                x, y, CHAR_TO_DIRECTION().value(direction));
+        }
+    }
+
+    void setColor(int x, int y, QChar color) override {
+        if (isWithinMaze(x, y)) {
+            getMazeGraphic()->setColor(x, y, CHAR_TO_COLOR().value(color));
+        }
+    }
+
+    void clearColor(int x, int y) override {
+        if (isWithinMaze(x, y)) {
+            getMazeGraphic()->clearColor(x, y);
+        }
+    }
+
+    void clearAllColor() override {
+        for (int x = 0; x < m_maze->getWidth(); x += 1) {
+            for (int y = 0; y < m_maze->getHeight(); y += 1) {
+                getMazeGraphic()->clearColor(x, y);
+            }
+        }
+    }
+
+    void setText(int x, int y, const QString& text) override {
+        if (isWithinMaze(x, y)) {
+            getMazeGraphic()->setText(x, y, text);
+        }
+    }
+
+    void clearText(int x, int y) override {
+        if (isWithinMaze(x, y)) {
+            getMazeGraphic()->clearText(x, y);
+        }
+    }
+
+    void clearAllText() override {
+        for (int x = 0; x < m_maze->getWidth(); x += 1) {
+            for (int y = 0; y < m_maze->getHeight(); y += 1) {
+                getMazeGraphic()->clearText(x, y);
+            }
+        }
+    }
+
+    bool wasReset() override {
+        return false;
+    }
+
+    void ackReset() override {
+        m_x = 0;
+        m_y = 0;
+        m_direction = Direction::NORTH;
+        if (m_world != nullptr) {
+            m_world->reset();
+        }
+    }
+
+private:
+
+    const Maze* m_maze;
+    MazeView m_view;
+    int m_x;
+    int m_y;
+    Direction m_direction;
+    Mouse m_mouse;
+    World* m_world;
+
+    bool isWithinMaze(int x, int y) const {
+        return 0 <= x && x < m_maze->getWidth() &&
+            0 <= y && y < m_maze->getHeight();
+    }
+};
+
+static void runWorkload(const Maze* maze, const QString& command) {
+
+    BenchMouse mouse(maze);
+    QProcess process;
+
+    // Hold on to incomplete lines until the rest of them arrives
+    QByteArray buffer;
+    QObject::connect(&process, &QProcess::readyReadStandardOutput, [&](){
+        buffer += process.readAllStandardOutput();
+        int start = 0;
+        int end = buffer.indexOf('\n');
+        while (end != -1) {
+            int length = end - start;
+            if (0 < length && buffer.at(end - 1) == '\r') {
+                length -= 1;
+            }
+            Command command =
+                CommandParser::parse(buffer.constData() + start, length);
+            QString response = CommandDispatcher::execute(&mouse, command);
+            if (!response.isEmpty() && response != CommandDispatcher::INVALID) {
+                process.write((response + "\n").toUtf8());
+            }
+            start = end + 1;
+            end = buffer.indexOf('\n', start);
+        }
+        buffer.remove(0, start);
+        // Stand in for a frame, which is when the simulator applies the
+        // visualization changes
+        mouse.getMazeGraphic()->flush();
+    });
+
+    // The client prints its results to stderr
+    QObject::connect(&process, &QProcess::readyReadStandardError, [&](){
+        out() << process.readAllStandardError();
+        out().flush();
+    });
+
+    QEventLoop loop;
+    QObject::connect(
+        &process,
+        static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(
+            &QProcess::finished
+        ),
+        &loop,
+        &QEventLoop::quit
+    );
+
+    QString directory = QCoreApplication::applicationDirPath();
+    if (!ProcessUtilities::start(command, directory, &process)) {
+        out() << command << ": " << process.errorString() << endl;
+        return;
+    }
+    loop.exec();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int size = 1 < args.size() ? args.at(1).toInt() : 16;
+
+    mms::WallGrid grid = mms::MazeGenerator::generateOfficial(
+        mms::MazeGeneratorType::TOMASZ, size, size, 0);
+    mms::Maze* maze = mms::Maze::fromWallGrid(grid);
+    if (maze == nullptr) {
+        mms::out() << "Couldn't generate a " << size << "x" << size << " maze" << endl;
+        return 1;
+    }
+
+    QString client = app.applicationDirPath() + "/mms-client";
+    for (const QString& workload : {
+        QString("query 100000"),
+        QString("visualization 100"),
+        QString("floodfill 100"),
+    }) {
+        mms::runWorkload(maze, client + " " + workload);
+    }
+
+    delete maze;
+    return 0;
+}
@@ -0,0 +1,53 @@
+QT += core
+QT -= gui
+
+TEMPLATE = app
+TARGET = mms-protocol-bench
+
+CONFIG += c++11
+CONFIG += console
+CONFIG += object_parallel_to_source
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../src
+
+SOURCES += $$files(*.cpp)
+
+# The headless parts of the simulator
+SOURCES += \
+    ../../src/BufferInterface.cpp \
+    ../../src/CollisionDetector.cpp \
+    ../../src/Color.cpp \
+    ../../src/ColorManager.cpp \
+    ../../src/CommandDispatcher.cpp \
+    ../../src/CommandParser.cpp \
+    ../../src/Dimensions.cpp \
+    ../../src/Direction.cpp \
+    ../../src/FontImage.cpp \
+    ../../src/GeometryUtilities.cpp \
+    ../../src/Maze.cpp \
+    ../../src/MazeChecker.cpp \
+    ../../src/MazeGenerator.cpp \
+    ../../src/MazeGraphic.cpp \
+    ../../src/MazeView.cpp \
+    ../../src/Mouse.cpp \
+    ../../src/Polygon.cpp \
+    ../../src/ProcessUtilities.cpp \
+    ../../src/RayCaster.cpp \
+    ../../src/Sensor.cpp \
+    ../../src/SimUtilities.cpp \
+    ../../src/TileGeometry.cpp \
+    ../../src/TileGraphic.cpp \
+    ../../src/TileGraphicTextCache.cpp \
+    ../../src/Trace.cpp \
+    ../../src/WallGrid.cpp \
+    ../../src/Wheel.cpp \
+    ../../src/World.cpp \
+    ../../src/polypartition/polypartition.cpp \
+    ../../src/units/Angle.cpp \
+    ../../src/units/Coordinate.cpp \
+    ../../src/units/Distance.cpp
+
+DESTDIR     = ../../bin
+MOC_DIR     = ../../build/protocol/moc
+OBJECTS_DIR = ../../build/protocol/obj
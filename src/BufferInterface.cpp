@@ -1,7 +1,8 @@
 #include "BufferInterface.h"
 
+#include <algorithm>
+
 #include "RGB.h"
-#include "SimUtilities.h"
 
 namespace mms {
 
@@ -30,11 +31,34 @@ QPair<int, int> BufferInterface::getTileGraphicTextMaxSize() {
     return m_tileGraphicTextCache.getTileGraphicTextMaxSize();
 }
 
-void BufferInterface::insertIntoGraphicCpuBuffer(const Polygon& polygon, Color color, unsigned char alpha) {
-    QVector<TriangleGraphic> tgs = SimUtilities::polygonToTriangleGraphics(polygon, color, alpha);
-    for (int i = 0; i < tgs.size(); i += 1) {
-        m_graphicCpuBuffer->append(tgs.at(i));
-    }
+void BufferInterface::insertIntoGraphicCpuBuffer(const QPair<Coordinate, Coordinate>& rectangle, Color color, unsigned char alpha) {
+
+    //   [p2]-------[UR]
+    //    |         / |
+    //    |  t1   /   |
+    //    |     /     |
+    //    |   /   t2  |
+    //    | /         |
+    //   [LL]-------[p3]
+
+    // Axis-aligned rectangles don't need to be triangulated
+    RGB rgb = COLOR_TO_RGB().value(color);
+    float left = static_cast<float>(rectangle.first.getX().getMeters());
+    float bottom = static_cast<float>(rectangle.first.getY().getMeters());
+    float right = static_cast<float>(rectangle.second.getX().getMeters());
+    float top = static_cast<float>(rectangle.second.getY().getMeters());
+    TriangleGraphic t1 {
+        {left, bottom, rgb, alpha},
+        {left, top, rgb, alpha},
+        {right, top, rgb, alpha},
+    };
+    TriangleGraphic t2 {
+        {left, bottom, rgb, alpha},
+        {right, top, rgb, alpha},
+        {right, bottom, rgb, alpha},
+    };
+    m_graphicCpuBuffer->append(t1);
+    m_graphicCpuBuffer->append(t2);
 }
 
 void BufferInterface::insertIntoTextureCpuBuffer() {
@@ -83,6 +107,54 @@ void BufferInterface::updateTileGraphicWallColor(int x, int y, Direction directi
 }
 
 void BufferInterface::updateTileGraphicText(int x, int y, int numRows, int numCols, int row, int col, QChar c) {
+    updateTileGraphicTextTriangles(
+        getTileGraphicTextStartingIndex(x, y, row, col),
+        m_tileGraphicTextCache.getTileOffset(x),
+        m_tileGraphicTextCache.getTileOffset(y),
+        m_tileGraphicTextCache.getTileGraphicTextRectangle(
+            numRows, numCols, row, col),
+        c);
+}
+
+void BufferInterface::updateTileGraphicText(int x, int y, const QString& text) {
+
+    QPair<int, int> maxRowsAndCols = getTileGraphicTextMaxSize();
+    int maxRows = maxRowsAndCols.first;
+    int maxCols = maxRowsAndCols.second;
+
+    // The text is split into rows of maxCols characters, and only the first
+    // maxRows of them are displayed; only the last row may be shorter
+    int length = text.size();
+    int numRows = std::min((length + maxCols - 1) / maxCols, maxRows);
+
+    // For all possible character positions, insert some character (blank if
+    // necessary); the positions are consecutive in the buffer
+    int index = getTileGraphicTextStartingIndex(x, y, 0, 0);
+    double xOffset = m_tileGraphicTextCache.getTileOffset(x);
+    double yOffset = m_tileGraphicTextCache.getTileOffset(y);
+    for (int row = 0; row < maxRows; row += 1) {
+        int numCols = row < numRows ?
+            std::min(length - row * maxCols, maxCols) :
+            0;
+        for (int col = 0; col < maxCols; col += 1) {
+            updateTileGraphicTextTriangles(
+                index,
+                xOffset,
+                yOffset,
+                m_tileGraphicTextCache.getTileGraphicTextRectangle(
+                    numRows, numCols, row, col),
+                col < numCols ? text.at(row * maxCols + col) : QChar(' '));
+            index += 2;
+        }
+    }
+}
+
+void BufferInterface::updateTileGraphicTextTriangles(
+        int index,
+        double xOffset,
+        double yOffset,
+        const TileGraphicTextRectangle& rectangle,
+        QChar c) {
 
     //    +---------[UR]  [p2]-------[p3]    [p2]
     //    |         / |    |         /       / |
@@ -92,34 +164,36 @@ void BufferInterface::updateTileGraphicText(int x, int y, int numRows, int numCo
     //    | /         |    | /       /         |
     //   [LL]---------+   [p1]     [p1]------[p3]
 
-    QPair<double, double> fontImageCharacterPosition =
+    const QPair<double, double>& fontImageCharacterPosition =
         m_tileGraphicTextCache.getFontImageCharacterPosition(c);
 
-    QPair<Coordinate, Coordinate> LL_UR =
-        m_tileGraphicTextCache.getTileGraphicTextPosition(x, y, numRows, numCols, row, col);
+    // The rectangle is relative to the starting tile, so shift it to this one
+    double left = rectangle.left + xOffset;
+    double bottom = rectangle.bottom + yOffset;
+    double right = rectangle.right + xOffset;
+    double top = rectangle.top + yOffset;
 
-    int triangleTextureIndex = getTileGraphicTextStartingIndex(x, y, row, col);
-    TriangleTexture* t1 = &(*m_textureCpuBuffer)[triangleTextureIndex];
-    TriangleTexture* t2 = &(*m_textureCpuBuffer)[triangleTextureIndex + 1];
+    TriangleTexture* t1 = &(*m_textureCpuBuffer)[index];
+    TriangleTexture* t2 = &(*m_textureCpuBuffer)[index + 1];
 
-    t1->p1.x = LL_UR.first.getX().getMeters();
-    t1->p1.y = LL_UR.first.getY().getMeters();
+    t1->p1.x = left;
+    t1->p1.y = bottom;
     t1->p1.u = fontImageCharacterPosition.first;
-    t1->p2.x = LL_UR.first.getX().getMeters();
-    t1->p2.y = LL_UR.second.getY().getMeters();
+    t1->p2.x = left;
+    t1->p2.y = top;
     t1->p2.u = fontImageCharacterPosition.first;
-    t1->p3.x = LL_UR.second.getX().getMeters();
-    t1->p3.y = LL_UR.second.getY().getMeters();
+    t1->p3.x = right;
+    t1->p3.y = top;
     t1->p3.u = fontImageCharacterPosition.second;
 
-    t2->p1.x = LL_UR.first.getX().getMeters();
-    t2->p1.y = LL_UR.first.getY().getMeters();
+    t2->p1.x = left;
+    t2->p1.y = bottom;
     t2->p1.u = fontImageCharacterPosition.first;
-    t2->p2.x = LL_UR.second.getX().getMeters();
-    t2->p2.y = LL_UR.second.getY().getMeters();
+    t2->p2.x = right;
+    t2->p2.y = top;
     t2->p2.u = fontImageCharacterPosition.second;
-    t2->p3.x = LL_UR.second.getX().getMeters();
-    t2->p3.y = LL_UR.first.getY().getMeters();
+    t2->p3.x = right;
+    t2->p3.y = bottom;
     t2->p3.u = fontImageCharacterPosition.second;
 }
 
@@ -6,10 +6,10 @@
 
 #include "Color.h"
 #include "Direction.h"
-#include "Polygon.h"
 #include "TileGraphicTextCache.h"
 #include "TriangleGraphic.h"
 #include "TriangleTexture.h"
+#include "units/Coordinate.h"
 
 namespace mms {
 
@@ -33,7 +33,7 @@ public:
     QPair<int, int> getTileGraphicTextMaxSize();
 
     // Fills the graphic cpu buffer and texture cpu buffer
-    void insertIntoGraphicCpuBuffer(const Polygon& polygon, Color color, unsigned char alpha);
+    void insertIntoGraphicCpuBuffer(const QPair<Coordinate, Coordinate>& rectangle, Color color, unsigned char alpha);
     void insertIntoTextureCpuBuffer();
 
     // These methods are inexpensive, and may be called many times
@@ -41,6 +41,10 @@ public:
     void updateTileGraphicWallColor(int x, int y, Direction direction, Color color, unsigned char alpha);
     void updateTileGraphicText(int x, int y, int numRows, int numCols, int row, int col, QChar c);
 
+    // Lays out the text in rows of up to the max number of cols, centered in
+    // the tile, and updates every character position of the tile
+    void updateTileGraphicText(int x, int y, const QString& text);
+
 private:
 
     // The width and height of the maze
@@ -63,6 +67,14 @@ private:
     // Retrieve the indices into the texture cpu buffer
     int getTileGraphicTextStartingIndex(int x, int y, int row, int col);
 
+    // Writes a single character, given the index of its first triangle
+    void updateTileGraphicTextTriangles(
+        int index,
+        double xOffset,
+        double yOffset,
+        const TileGraphicTextRectangle& rectangle,
+        QChar c);
+
 };
 
 } 
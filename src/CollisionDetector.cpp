@@ -0,0 +1,243 @@
+#include "CollisionDetector.h"
+
+#include <QtGlobal>
+#include <QtMath>
+
+#include <cmath>
+
+#include "Dimensions.h"
+
+namespace mms {
+
+const double CollisionDetector::FRACTION_TOLERANCE = 0.001;
+
+bool CollisionDetector::findImpact(
+        const WallGrid& grid,
+        const QVector<Point>& body,
+        const Pose& from,
+        const Pose& to,
+        double* fraction) {
+
+    static const double halfWallWidth = Dimensions::halfWallWidth().getMeters();
+
+    // The broad phase is done once, for the box swept by the whole step
+    Vertices vertices;
+    transform(body, from, &vertices);
+    Box bounds = getBounds(vertices);
+    transform(body, to, &vertices);
+    Box toBounds = getBounds(vertices);
+    bounds.minX = qMin(bounds.minX, toBounds.minX);
+    bounds.minY = qMin(bounds.minY, toBounds.minY);
+    bounds.maxX = qMax(bounds.maxX, toBounds.maxX);
+    bounds.maxY = qMax(bounds.maxY, toBounds.maxY);
+    Obstacles obstacles;
+    gatherObstacles(grid, bounds, &obstacles);
+    if (obstacles.isEmpty()) {
+        return false;
+    }
+
+    // No vertex may move farther than half a wall width between samples, or
+    // it could pass right through a wall without ever overlapping it
+    double radius = 0.0;
+    for (const Point& point : body) {
+        radius = qMax(radius, std::sqrt(point.x * point.x + point.y * point.y));
+    }
+    double distance =
+        std::sqrt(
+            (to.x - from.x) * (to.x - from.x) +
+            (to.y - from.y) * (to.y - from.y)) +
+        radius * qAbs(to.rotation - from.rotation);
+    int samples = qMax(1, qCeil(distance / halfWallWidth));
+
+    // Find the first sample that collides, then bisect between it and the
+    // previous one
+    for (int i = 1; i <= samples; i += 1) {
+        double hit = static_cast<double>(i) / samples;
+        if (!isColliding(body, interpolate(from, to, hit), obstacles)) {
+            continue;
+        }
+        double clear = static_cast<double>(i - 1) / samples;
+        while (FRACTION_TOLERANCE < hit - clear) {
+            double middle = (clear + hit) / 2.0;
+            if (isColliding(body, interpolate(from, to, middle), obstacles)) {
+                hit = middle;
+            }
+            else {
+                clear = middle;
+            }
+        }
+        *fraction = clear;
+        return true;
+    }
+    return false;
+}
+
+CollisionDetector::Pose CollisionDetector::interpolate(
+        const Pose& from,
+        const Pose& to,
+        double fraction) {
+    return {
+        from.x + (to.x - from.x) * fraction,
+        from.y + (to.y - from.y) * fraction,
+        from.rotation + (to.rotation - from.rotation) * fraction,
+    };
+}
+
+void CollisionDetector::transform(
+        const QVector<Point>& body,
+        const Pose& pose,
+        Vertices* vertices) {
+    double cos = std::cos(pose.rotation);
+    double sin = std::sin(pose.rotation);
+    vertices->clear();
+    for (const Point& point : body) {
+        vertices->append({
+            pose.x + point.x * cos - point.y * sin,
+            pose.y + point.x * sin + point.y * cos,
+        });
+    }
+}
+
+CollisionDetector::Box CollisionDetector::getBounds(const Vertices& vertices) {
+    Box bounds = {
+        vertices.at(0).x,
+        vertices.at(0).y,
+        vertices.at(0).x,
+        vertices.at(0).y,
+    };
+    for (const Point& vertex : vertices) {
+        bounds.minX = qMin(bounds.minX, vertex.x);
+        bounds.minY = qMin(bounds.minY, vertex.y);
+        bounds.maxX = qMax(bounds.maxX, vertex.x);
+        bounds.maxY = qMax(bounds.maxY, vertex.y);
+    }
+    return bounds;
+}
+
+void CollisionDetector::gatherObstacles(
+        const WallGrid& grid,
+        const Box& bounds,
+        Obstacles* obstacles) {
+
+    static const double halfWallWidth = Dimensions::halfWallWidth().getMeters();
+    static const double tileLength = Dimensions::tileLength().getMeters();
+
+    // The tile edges near the box: posts are on the corners of the tiles, and
+    // walls run between them. Each edge is visited once, rather than once for
+    // each tile that it belongs to.
+    const unsigned char* walls = grid.data();
+    int width = grid.getWidth();
+    int height = grid.getHeight();
+    int minEdgeX =
+        qMax(0, qCeil((bounds.minX - halfWallWidth) / tileLength));
+    int maxEdgeX =
+        qMin(width, qFloor((bounds.maxX + halfWallWidth) / tileLength));
+    int minEdgeY =
+        qMax(0, qCeil((bounds.minY - halfWallWidth) / tileLength));
+    int maxEdgeY =
+        qMin(height, qFloor((bounds.maxY + halfWallWidth) / tileLength));
+    int minTileX = qMax(0, qFloor(bounds.minX / tileLength));
+    int maxTileX = qMin(width - 1, qFloor(bounds.maxX / tileLength));
+    int minTileY = qMax(0, qFloor(bounds.minY / tileLength));
+    int maxTileY = qMin(height - 1, qFloor(bounds.maxY / tileLength));
+
+    // Every post is present, whether or not any walls meet at it
+    for (int x = minEdgeX; x <= maxEdgeX; x += 1) {
+        for (int y = minEdgeY; y <= maxEdgeY; y += 1) {
+            obstacles->append({
+                tileLength * x - halfWallWidth,
+                tileLength * y - halfWallWidth,
+                tileLength * x + halfWallWidth,
+                tileLength * y + halfWallWidth,
+            });
+        }
+    }
+
+    // Walls are present if either tile on either side of them says so
+    unsigned char east = WallGrid::bit(Direction::EAST);
+    unsigned char west = WallGrid::bit(Direction::WEST);
+    for (int x = minEdgeX; x <= maxEdgeX; x += 1) {
+        for (int y = minTileY; y <= maxTileY; y += 1) {
+            if (
+                (x < width && (walls[height * x + y] & west) != 0) ||
+                (0 < x && (walls[height * (x - 1) + y] & east) != 0)
+            ) {
+                obstacles->append({
+                    tileLength * x - halfWallWidth,
+                    tileLength * y + halfWallWidth,
+                    tileLength * x + halfWallWidth,
+                    tileLength * (y + 1) - halfWallWidth,
+                });
+            }
+        }
+    }
+    unsigned char north = WallGrid::bit(Direction::NORTH);
+    unsigned char south = WallGrid::bit(Direction::SOUTH);
+    for (int x = minTileX; x <= maxTileX; x += 1) {
+        for (int y = minEdgeY; y <= maxEdgeY; y += 1) {
+            if (
+                (y < height && (walls[height * x + y] & south) != 0) ||
+                (0 < y && (walls[height * x + y - 1] & north) != 0)
+            ) {
+                obstacles->append({
+                    tileLength * x + halfWallWidth,
+                    tileLength * y - halfWallWidth,
+                    tileLength * (x + 1) - halfWallWidth,
+                    tileLength * y + halfWallWidth,
+                });
+            }
+        }
+    }
+}
+
+bool CollisionDetector::isSeparated(const Vertices& vertices, const Box& box) {
+
+    // The axes of the box are tested by the caller, with the bounding box of
+    // the vertices, so only the normals of the edges of the body are left
+    double centerX = (box.minX + box.maxX) / 2.0;
+    double centerY = (box.minY + box.maxY) / 2.0;
+    double halfWidth = (box.maxX - box.minX) / 2.0;
+    double halfHeight = (box.maxY - box.minY) / 2.0;
+    for (int i = 0; i < vertices.size(); i += 1) {
+        const Point& start = vertices.at(i);
+        const Point& end = vertices.at((i + 1) % vertices.size());
+        double normalX = start.y - end.y;
+        double normalY = end.x - start.x;
+        double min = normalX * start.x + normalY * start.y;
+        double max = min;
+        for (const Point& vertex : vertices) {
+            double projection = normalX * vertex.x + normalY * vertex.y;
+            min = qMin(min, projection);
+            max = qMax(max, projection);
+        }
+        double center = normalX * centerX + normalY * centerY;
+        double extent = qAbs(normalX) * halfWidth + qAbs(normalY) * halfHeight;
+        if (max < center - extent || center + extent < min) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CollisionDetector::isColliding(
+        const QVector<Point>& body,
+        const Pose& pose,
+        const Obstacles& obstacles) {
+    Vertices vertices;
+    transform(body, pose, &vertices);
+    Box bounds = getBounds(vertices);
+    for (const Box& box : obstacles) {
+        if (
+            box.maxX < bounds.minX || bounds.maxX < box.minX ||
+            box.maxY < bounds.minY || bounds.maxY < box.minY
+        ) {
+            continue;
+        }
+        if (!isSeparated(vertices, box)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QVector>
+
+#include "Polygon.h"
+#include "SmallVector.h"
+#include "WallGrid.h"
+
+namespace mms {
+
+// Detects collisions between the body of a continuously simulated mouse and
+// the walls and posts of the maze. The broad phase only gathers the walls and
+// posts on the edges of the tiles that the bounding box of the body overlaps;
+// the narrow phase tests each of them with the separating axis theorem, which
+// is exact since the body is convex and every wall and post is a rectangle.
+// Lengths are in meters, and angles in radians.
+class CollisionDetector {
+
+public:
+
+    // The CollisionDetector class is not constructible
+    CollisionDetector() = delete;
+
+    struct Point {
+        double x;
+        double y;
+    };
+
+    struct Pose {
+        double x;
+        double y;
+        double rotation;
+    };
+
+    // Finds the time of impact of a body that moves from one pose to another
+    // during a step. Returns false if the body doesn't touch anything along
+    // the way; otherwise, fraction is the fraction of the step at which the
+    // body was last clear of the walls, to within FRACTION_TOLERANCE. The
+    // body is a convex polygon relative to the center of the mouse, with the
+    // mouse facing along the x axis.
+    static bool findImpact(
+        const WallGrid& grid,
+        const QVector<Point>& body,
+        const Pose& from,
+        const Pose& to,
+        double* fraction);
+
+    static Pose interpolate(const Pose& from, const Pose& to, double fraction);
+
+private:
+
+    static const double FRACTION_TOLERANCE;
+
+    // An axis-aligned rectangle, i.e., a wall, a post, or a bounding box
+    struct Box {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+    };
+
+    // The walls and posts near a mouse; enough for any step of any mouse
+    // without a heap allocation
+    static const int MAX_INLINE_OBSTACLES = 32;
+    typedef SmallVector<Box, MAX_INLINE_OBSTACLES> Obstacles;
+    typedef SmallVector<Point, Polygon::MAX_INLINE_VERTICES> Vertices;
+
+    static void transform(
+        const QVector<Point>& body,
+        const Pose& pose,
+        Vertices* vertices);
+    static Box getBounds(const Vertices& vertices);
+    static void gatherObstacles(
+        const WallGrid& grid,
+        const Box& bounds,
+        Obstacles* obstacles);
+    static bool isSeparated(const Vertices& vertices, const Box& box);
+    static bool isColliding(
+        const QVector<Point>& body,
+        const Pose& pose,
+        const Obstacles& obstacles);
+};
+
+}
@@ -0,0 +1,156 @@
+#include "CommandDispatcher.h"
+
+#include <QStringList>
+
+namespace mms {
+
+const QString CommandDispatcher::ACK = "ack";
+const QString CommandDispatcher::CRASH = "crash";
+const QString CommandDispatcher::ON_WHEELS = "onWheels";
+const QString CommandDispatcher::INVALID = "invalid";
+
+const CommandDispatcher::Handler
+CommandDispatcher::HANDLERS[NUM_COMMAND_TYPES] = {
+#define COMMAND_HANDLER(type, name, arguments, blocking)\
+    &CommandDispatcher::name,
+    COMMAND_LIST(COMMAND_HANDLER)
+#undef COMMAND_HANDLER
+    &CommandDispatcher::invalid,
+};
+
+QString CommandDispatcher::execute(
+        MouseInterface* mouse,
+        const Command& command) {
+    return HANDLERS[static_cast<int>(command.type)](mouse, command);
+}
+
+QString CommandDispatcher::mazeWidth(MouseInterface* mouse, const Command&) {
+    return QString::number(mouse->mazeWidth());
+}
+
+QString CommandDispatcher::mazeHeight(MouseInterface* mouse, const Command&) {
+    return QString::number(mouse->mazeHeight());
+}
+
+QString CommandDispatcher::wallFront(MouseInterface* mouse, const Command&) {
+    return boolToString(mouse->wallFront());
+}
+
+QString CommandDispatcher::wallRight(MouseInterface* mouse, const Command&) {
+    return boolToString(mouse->wallRight());
+}
+
+QString CommandDispatcher::wallLeft(MouseInterface* mouse, const Command&) {
+    return boolToString(mouse->wallLeft());
+}
+
+QString CommandDispatcher::moveForward(MouseInterface* mouse, const Command&) {
+    return mouse->moveForward();
+}
+
+QString CommandDispatcher::turnRight(MouseInterface* mouse, const Command&) {
+    return mouse->turnRight();
+}
+
+QString CommandDispatcher::turnLeft(MouseInterface* mouse, const Command&) {
+    return mouse->turnLeft();
+}
+
+QString CommandDispatcher::setWall(
+        MouseInterface* mouse,
+        const Command& command) {
+    mouse->setWall(command.x, command.y, command.character);
+    return QString();
+}
+
+QString CommandDispatcher::clearWall(
+        MouseInterface* mouse,
+        const Command& command) {
+    mouse->clearWall(command.x, command.y, command.character);
+    return QString();
+}
+
+QString CommandDispatcher::setColor(
+        MouseInterface* mouse,
+        const Command& command) {
+    mouse->setColor(command.x, command.y, command.character);
+    return QString();
+}
+
+QString CommandDispatcher::clearColor(
+        MouseInterface* mouse,
+        const Command& command) {
+    mouse->clearColor(command.x, command.y);
+    return QString();
+}
+
+QString CommandDispatcher::clearAllColor(
+        MouseInterface* mouse,
+        const Command&) {
+    mouse->clearAllColor();
+    return QString();
+}
+
+QString CommandDispatcher::setText(
+        MouseInterface* mouse,
+        const Command& command) {
+    mouse->setText(command.x, command.y, command.text);
+    return QString();
+}
+
+QString CommandDispatcher::clearText(
+        MouseInterface* mouse,
+        const Command& command) {
+    mouse->clearText(command.x, command.y);
+    return QString();
+}
+
+QString CommandDispatcher::clearAllText(
+        MouseInterface* mouse,
+        const Command&) {
+    mouse->clearAllText();
+    return QString();
+}
+
+QString CommandDispatcher::wasReset(MouseInterface* mouse, const Command&) {
+    return boolToString(mouse->wasReset());
+}
+
+QString CommandDispatcher::ackReset(MouseInterface* mouse, const Command&) {
+    mouse->ackReset();
+    return ACK;
+}
+
+QString CommandDispatcher::setWheelSpeeds(
+        MouseInterface* mouse,
+        const Command& command) {
+    mouse->setWheelSpeeds(command.x, command.y);
+    return QString();
+}
+
+QString CommandDispatcher::readEncoders(
+        MouseInterface* mouse,
+        const Command&) {
+    QPair<int, int> ticks = mouse->readEncoders();
+    return QString("%1 %2").arg(ticks.first).arg(ticks.second);
+}
+
+QString CommandDispatcher::readSensors(
+        MouseInterface* mouse,
+        const Command&) {
+    QStringList readings;
+    for (double reading : mouse->readSensors()) {
+        readings.append(QString::number(reading));
+    }
+    return readings.join(" ");
+}
+
+QString CommandDispatcher::invalid(MouseInterface*, const Command&) {
+    return INVALID;
+}
+
+QString CommandDispatcher::boolToString(bool value) {
+    return value ? "true" : "false";
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QChar>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include "CommandParser.h"
+
+namespace mms {
+
+// A mouse that commands can be performed on, with one function per command.
+// What the functions mean is up to the implementation, e.g., the GUI animates
+// movements and draws on the maze, while the headless tools move instantly
+// and draw nothing.
+class MouseInterface {
+
+public:
+
+    virtual ~MouseInterface() = default;
+
+    virtual int mazeWidth() = 0;
+    virtual int mazeHeight() = 0;
+
+    virtual bool wallFront() = 0;
+    virtual bool wallRight() = 0;
+    virtual bool wallLeft() = 0;
+
+    // Movements return their response: ACK or CRASH if they're done at once,
+    // ON_WHEELS if the mouse can't move a tile at a time, or an empty string
+    // if the response is sent once the movement is done
+    virtual QString moveForward() = 0;
+    virtual QString turnRight() = 0;
+    virtual QString turnLeft() = 0;
+
+    // Speeds are in degrees per second
+    virtual void setWheelSpeeds(int left, int right) = 0;
+    virtual QPair<int, int> readEncoders() = 0;
+    virtual QVector<double> readSensors() = 0;
+
+    virtual void setWall(int x, int y, QChar direction) = 0;
+    virtual void clearWall(int x, int y, QChar direction) = 0;
+
+    virtual void setColor(int x, int y, QChar color) = 0;
+    virtual void clearColor(int x, int y) = 0;
+    virtual void clearAllColor() = 0;
+
+    virtual void setText(int x, int y, const QString& text) = 0;
+    virtual void clearText(int x, int y) = 0;
+    virtual void clearAllText() = 0;
+
+    virtual bool wasReset() = 0;
+    virtual void ackReset() = 0;
+};
+
+// Performs parsed commands on a mouse and formats their responses. This is
+// the only implementation of the protocol; the GUI, the tournament, and the
+// benchmarks differ only in their mice.
+class CommandDispatcher {
+
+public:
+
+    // The CommandDispatcher class is not constructible
+    CommandDispatcher() = delete;
+
+    static const QString ACK;
+    static const QString CRASH;
+    static const QString ON_WHEELS;
+    static const QString INVALID;
+
+    // Returns the response to the command; an empty response means that
+    // there's nothing to send yet, either because the command doesn't have a
+    // response or because the response is sent once the movement that it
+    // started is done. Invalid commands get INVALID, which isn't sent.
+    static QString execute(MouseInterface* mouse, const Command& command);
+
+private:
+
+    // Indexed by CommandType, and expanded from COMMAND_LIST, so there's a
+    // handler for every command, in order
+    typedef QString (*Handler)(MouseInterface* mouse, const Command& command);
+    static const Handler HANDLERS[NUM_COMMAND_TYPES];
+
+#define COMMAND_HANDLER(type, name, arguments, blocking)\
+    static QString name(MouseInterface* mouse, const Command& command);
+    COMMAND_LIST(COMMAND_HANDLER)
+#undef COMMAND_HANDLER
+    static QString invalid(MouseInterface* mouse, const Command& command);
+
+    static QString boolToString(bool value);
+};
+
+}
@@ -0,0 +1,226 @@
+#include "CommandParser.h"
+
+#include <array>
+#include <climits>
+#include <cstring>
+
+#include "Color.h"
+#include "Direction.h"
+
+namespace mms {
+
+const CommandSpec CommandParser::COMMAND_SPECS[NUM_COMMAND_TYPES] = {
+#define COMMAND_SPEC(type, name, arguments, blocking)\
+    {#name, sizeof(#name) - 1, CommandArguments::arguments, blocking},
+    COMMAND_LIST(COMMAND_SPEC)
+#undef COMMAND_SPEC
+    {"invalid", 7, CommandArguments::NONE, false},
+};
+
+Command CommandParser::parse(const char* line, int length) {
+
+    Command command = {CommandType::INVALID, 0, 0, QChar(), QString()};
+    Token tokens[MAX_TOKENS];
+    int count = tokenize(line, length, tokens, MAX_TOKENS);
+    if (count == 0) {
+        return command;
+    }
+    CommandType type = getType(tokens[0]);
+    if (type == CommandType::INVALID) {
+        return command;
+    }
+
+    // Parse the arguments according to the spec, into a copy of the command
+    // so that nothing is half-filled if they're invalid
+    Command parsed = command;
+    switch (getSpec(type).arguments) {
+        case CommandArguments::NONE:
+            if (count != 1) {
+                return command;
+            }
+            break;
+        case CommandArguments::POSITION:
+        case CommandArguments::SPEEDS:
+            if (count != 3 || !parsePosition(tokens, &parsed)) {
+                return command;
+            }
+            break;
+        case CommandArguments::POSITION_DIRECTION:
+        case CommandArguments::POSITION_COLOR: {
+            if (count != 4 || !parsePosition(tokens, &parsed)) {
+                return command;
+            }
+            if (tokens[3].length != 1) {
+                return command;
+            }
+            QChar character = QLatin1Char(tokens[3].data[0]);
+            if (
+                getSpec(type).arguments == CommandArguments::POSITION_COLOR ?
+                !CHAR_TO_COLOR().contains(character) :
+                !CHAR_TO_DIRECTION().contains(character)
+            ) {
+                return command;
+            }
+            parsed.character = character;
+            break;
+        }
+        case CommandArguments::POSITION_TEXT:
+            // Tokenizing would lose the spaces in the text
+            return parseSetText(line, length);
+    }
+    parsed.type = type;
+    return parsed;
+}
+
+Command CommandParser::parse(const QByteArray& line) {
+    return parse(line.constData(), line.size());
+}
+
+const CommandSpec& CommandParser::getSpec(CommandType type) {
+    return COMMAND_SPECS[static_cast<int>(type)];
+}
+
+bool CommandParser::isInline(CommandType type) {
+    return type != CommandType::INVALID && !getSpec(type).blocking;
+}
+
+int CommandParser::tokenize(
+        const char* line,
+        int length,
+        Token* tokens,
+        int maxTokens) {
+    int count = 0;
+    int i = 0;
+    while (i < length) {
+        // Skip empty parts, like QString::SkipEmptyParts
+        if (line[i] == ' ') {
+            i += 1;
+            continue;
+        }
+        int start = i;
+        while (i < length && line[i] != ' ') {
+            i += 1;
+        }
+        if (count < maxTokens) {
+            tokens[count] = {line + start, i - start};
+        }
+        count += 1;
+    }
+    return count;
+}
+
+quint32 CommandParser::hash(const char* data, int length) {
+    // FNV-1a, which is plenty for a handful of short names
+    quint32 value = 2166136261u;
+    for (int i = 0; i < length; i += 1) {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 16777619u;
+    }
+    return value;
+}
+
+CommandType CommandParser::getType(const Token& name) {
+
+    // Empty slots hold INVALID, so there must be at least one of them
+    static_assert(
+        NUM_COMMAND_TYPES - 1 < HASH_TABLE_SIZE,
+        "The command hash table is too small");
+    static const std::array<CommandType, HASH_TABLE_SIZE> table = [](){
+        std::array<CommandType, HASH_TABLE_SIZE> table;
+        table.fill(CommandType::INVALID);
+        for (int i = 0; i < NUM_COMMAND_TYPES - 1; i += 1) {
+            const CommandSpec& spec = COMMAND_SPECS[i];
+            int slot = hash(spec.name, spec.length) % HASH_TABLE_SIZE;
+            while (table[slot] != CommandType::INVALID) {
+                slot = (slot + 1) % HASH_TABLE_SIZE;
+            }
+            table[slot] = static_cast<CommandType>(i);
+        }
+        return table;
+    }();
+
+    int slot = hash(name.data, name.length) % HASH_TABLE_SIZE;
+    while (table[slot] != CommandType::INVALID) {
+        const CommandSpec& spec = getSpec(table[slot]);
+        if (
+            spec.length == name.length &&
+            std::memcmp(spec.name, name.data, name.length) == 0
+        ) {
+            return table[slot];
+        }
+        slot = (slot + 1) % HASH_TABLE_SIZE;
+    }
+    return CommandType::INVALID;
+}
+
+bool CommandParser::toInt(const Token& token, int* value) {
+    int i = 0;
+    bool negative = false;
+    if (0 < token.length && (token.data[0] == '-' || token.data[0] == '+')) {
+        negative = token.data[0] == '-';
+        i += 1;
+    }
+    if (i == token.length) {
+        return false;
+    }
+    long long result = 0;
+    for (; i < token.length; i += 1) {
+        char c = token.data[i];
+        if (c < '0' || '9' < c) {
+            return false;
+        }
+        result = 10 * result + (c - '0');
+        if (static_cast<long long>(INT_MAX) + 1 < result) {
+            return false;
+        }
+    }
+    result = negative ? -result : result;
+    if (result < INT_MIN || INT_MAX < result) {
+        return false;
+    }
+    *value = static_cast<int>(result);
+    return true;
+}
+
+bool CommandParser::parsePosition(const Token* tokens, Command* command) {
+    return toInt(tokens[1], &command->x) && toInt(tokens[2], &command->y);
+}
+
+Command CommandParser::parseSetText(const char* line, int length) {
+    Command command = {CommandType::INVALID, 0, 0, QChar(), QString()};
+    // The text is everything after the third space, so the name must be
+    // followed by exactly one space, as must the coordinates
+    const CommandSpec& spec = getSpec(CommandType::SET_TEXT);
+    const char* end = line + length;
+    if (length <= spec.length || line[spec.length] != ' ') {
+        return command;
+    }
+    const char* firstSpace = line + spec.length;
+    const char* secondSpace = static_cast<const char*>(
+        std::memchr(firstSpace + 1, ' ', end - firstSpace - 1));
+    if (secondSpace == nullptr) {
+        return command;
+    }
+    const char* thirdSpace = static_cast<const char*>(
+        std::memchr(secondSpace + 1, ' ', end - secondSpace - 1));
+    if (thirdSpace == nullptr) {
+        thirdSpace = end;
+    }
+    Token tokens[3] = {
+        {line, spec.length},
+        {firstSpace + 1, static_cast<int>(secondSpace - firstSpace - 1)},
+        {secondSpace + 1, static_cast<int>(thirdSpace - secondSpace - 1)},
+    };
+    Command parsed = command;
+    if (!parsePosition(tokens, &parsed)) {
+        return command;
+    }
+    parsed.type = CommandType::SET_TEXT;
+    if (thirdSpace < end) {
+        parsed.text = QString::fromUtf8(
+            thirdSpace + 1, static_cast<int>(end - thirdSpace - 1));
+    }
+    return parsed;
+}
+
+}
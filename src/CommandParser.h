@@ -0,0 +1,132 @@
+#pragma once
+
+#include <QByteArray>
+#include <QChar>
+#include <QString>
+
+namespace mms {
+
+// The arguments that a command takes, after its name
+enum class CommandArguments {
+    NONE,
+    // x y
+    POSITION,
+    // x y direction
+    POSITION_DIRECTION,
+    // x y color
+    POSITION_COLOR,
+    // x y text, where the text may contain spaces
+    POSITION_TEXT,
+    // left right, as whole degrees per second
+    SPEEDS,
+};
+
+// Every command in the protocol: its type, its name, its arguments, and
+// whether the algorithm blocks waiting for a response. Blocking commands are
+// queued and performed one at a time, in order; the rest are performed as
+// soon as they arrive. This is the only list of commands, and everything else
+// (the CommandType enum, parsing, the stats, and the handlers of the
+// CommandDispatcher, which are named after the commands) is expanded from it.
+#define COMMAND_LIST(COMMAND)\
+    COMMAND(MAZE_WIDTH,       mazeWidth,      NONE,               true)\
+    COMMAND(MAZE_HEIGHT,      mazeHeight,     NONE,               true)\
+    COMMAND(WALL_FRONT,       wallFront,      NONE,               true)\
+    COMMAND(WALL_RIGHT,       wallRight,      NONE,               true)\
+    COMMAND(WALL_LEFT,        wallLeft,       NONE,               true)\
+    COMMAND(MOVE_FORWARD,     moveForward,    NONE,               true)\
+    COMMAND(TURN_RIGHT,       turnRight,      NONE,               true)\
+    COMMAND(TURN_LEFT,        turnLeft,       NONE,               true)\
+    COMMAND(SET_WALL,         setWall,        POSITION_DIRECTION, false)\
+    COMMAND(CLEAR_WALL,       clearWall,      POSITION_DIRECTION, false)\
+    COMMAND(SET_COLOR,        setColor,       POSITION_COLOR,     false)\
+    COMMAND(CLEAR_COLOR,      clearColor,     POSITION,           false)\
+    COMMAND(CLEAR_ALL_COLOR,  clearAllColor,  NONE,               false)\
+    COMMAND(SET_TEXT,         setText,        POSITION_TEXT,      false)\
+    COMMAND(CLEAR_TEXT,       clearText,      POSITION,           false)\
+    COMMAND(CLEAR_ALL_TEXT,   clearAllText,   NONE,               false)\
+    COMMAND(WAS_RESET,        wasReset,       NONE,               true)\
+    COMMAND(ACK_RESET,        ackReset,       NONE,               true)\
+    COMMAND(SET_WHEEL_SPEEDS, setWheelSpeeds, SPEEDS,             false)\
+    COMMAND(READ_ENCODERS,    readEncoders,   NONE,               true)\
+    COMMAND(READ_SENSORS,     readSensors,    NONE,               true)
+
+enum class CommandType {
+#define COMMAND_TYPE(type, name, arguments, blocking) type,
+    COMMAND_LIST(COMMAND_TYPE)
+#undef COMMAND_TYPE
+    INVALID,
+};
+
+static const int NUM_COMMAND_TYPES = static_cast<int>(CommandType::INVALID) + 1;
+
+struct CommandSpec {
+    const char* name;
+    int length;
+    CommandArguments arguments;
+    bool blocking;
+};
+
+// A command from the mouse algorithm, along with whichever of the arguments
+// its type takes; the character is a direction or a color, and the speeds of
+// setWheelSpeeds are in x and y
+struct Command {
+    CommandType type;
+    int x;
+    int y;
+    QChar character;
+    QString text;
+};
+
+class CommandParser {
+
+public:
+
+    // The CommandParser class is not constructible
+    CommandParser() = delete;
+
+    // Parses a line of the algorithm's output, without its newline, in place.
+    // Nothing is allocated except the text of setText commands. Returns a
+    // command of type INVALID if the line isn't a valid command.
+    static Command parse(const char* line, int length);
+    static Command parse(const QByteArray& line);
+
+    // The spec of any command type, including INVALID
+    static const CommandSpec& getSpec(CommandType type);
+
+    // Commands that don't elicit a response are performed as soon as they
+    // arrive, rather than queued with the commands that do
+    static bool isInline(CommandType type);
+
+private:
+
+    static const CommandSpec COMMAND_SPECS[NUM_COMMAND_TYPES];
+
+    // A space-separated part of a line, which points into the line
+    struct Token {
+        const char* data;
+        int length;
+    };
+
+    // The most tokens that any command has
+    static const int MAX_TOKENS = 4;
+
+    // Returns the number of tokens in the line, but only fills in the first
+    // maxTokens of them
+    static int tokenize(
+        const char* line,
+        int length,
+        Token* tokens,
+        int maxTokens);
+
+    // Command types are looked up by name in an open-addressing hash table,
+    // built from the specs the first time that it's used
+    static const int HASH_TABLE_SIZE = 64;
+    static quint32 hash(const char* data, int length);
+    static CommandType getType(const Token& name);
+
+    static bool toInt(const Token& token, int* value);
+    static bool parsePosition(const Token* tokens, Command* command);
+    static Command parseSetText(const char* line, int length);
+};
+
+}
@@ -0,0 +1,187 @@
+#include "CommandStats.h"
+
+#include <QJsonArray>
+#include <QtAlgorithms>
+
+#include <chrono>
+
+namespace mms {
+
+const char* const CommandStats::STAGE_NAMES[NUM_STAGES] = {
+    "arrival",
+    "handler",
+    "queue",
+    "animation",
+    "response",
+};
+
+CommandStats::CommandStats() {
+    reset();
+}
+
+qint64 CommandStats::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+void CommandStats::record(CommandType type, CommandStage stage, qint64 nanoseconds) {
+    quint64 duration = 0 < nanoseconds ? nanoseconds : 0;
+    Histogram& histogram =
+        m_histograms[static_cast<int>(type)][static_cast<int>(stage)];
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.total.fetch_add(duration, std::memory_order_relaxed);
+    histogram.buckets[bucketIndex(duration)].fetch_add(
+        1, std::memory_order_relaxed);
+    quint64 max = histogram.max.load(std::memory_order_relaxed);
+    while (
+        max < duration &&
+        !histogram.max.compare_exchange_weak(
+            max, duration, std::memory_order_relaxed)
+    ) {
+    }
+}
+
+void CommandStats::reset() {
+    m_startTime.store(now(), std::memory_order_relaxed);
+    for (int i = 0; i < NUM_COMMAND_TYPES; i += 1) {
+        for (int j = 0; j < NUM_STAGES; j += 1) {
+            Histogram& histogram = m_histograms[i][j];
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.total.store(0, std::memory_order_relaxed);
+            histogram.max.store(0, std::memory_order_relaxed);
+            for (int k = 0; k < NUM_BUCKETS; k += 1) {
+                histogram.buckets[k].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+QString CommandStats::toText() const {
+
+    double seconds =
+        (now() - m_startTime.load(std::memory_order_relaxed)) / 1e9;
+    quint64 commands = 0;
+    for (int i = 0; i < NUM_COMMAND_TYPES; i += 1) {
+        commands += m_histograms[i][static_cast<int>(CommandStage::ARRIVAL)]
+            .count.load(std::memory_order_relaxed);
+    }
+
+    QString text = QString("%1 commands in %2 s (%3 commands/s)\n\n").arg(
+        QString::number(commands),
+        QString::number(seconds, 'f', 1),
+        QString::number(0.0 < seconds ? commands / seconds : 0.0, 'f', 1)
+    );
+    text += QString("%1%2%3%4%5%6%7\n").arg(
+        QString("command").leftJustified(15),
+        QString("stage").leftJustified(11),
+        QString("count").rightJustified(9),
+        QString("mean").rightJustified(10),
+        QString("p50").rightJustified(10),
+        QString("p99").rightJustified(10),
+        QString("max").rightJustified(10)
+    );
+
+    for (int i = 0; i < NUM_COMMAND_TYPES; i += 1) {
+        QString name = CommandParser::getSpec(static_cast<CommandType>(i)).name;
+        for (int j = 0; j < NUM_STAGES; j += 1) {
+            const Histogram& histogram = m_histograms[i][j];
+            quint64 count = histogram.count.load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            quint64 total = histogram.total.load(std::memory_order_relaxed);
+            text += QString("%1%2%3%4%5%6%7\n").arg(
+                name.leftJustified(15),
+                QString(STAGE_NAMES[j]).leftJustified(11),
+                QString::number(count).rightJustified(9),
+                formatDuration(total / count).rightJustified(10),
+                formatDuration(percentile(histogram, 0.50)).rightJustified(10),
+                formatDuration(percentile(histogram, 0.99)).rightJustified(10),
+                formatDuration(histogram.max.load(std::memory_order_relaxed))
+                    .rightJustified(10)
+            );
+        }
+    }
+
+    return text;
+}
+
+QJsonObject CommandStats::toJson() const {
+
+    QJsonObject commands;
+    for (int i = 0; i < NUM_COMMAND_TYPES; i += 1) {
+        QString name = CommandParser::getSpec(static_cast<CommandType>(i)).name;
+        QJsonObject stages;
+        for (int j = 0; j < NUM_STAGES; j += 1) {
+            const Histogram& histogram = m_histograms[i][j];
+            quint64 count = histogram.count.load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            QJsonArray buckets;
+            for (int k = 0; k < NUM_BUCKETS; k += 1) {
+                buckets.append(static_cast<double>(
+                    histogram.buckets[k].load(std::memory_order_relaxed)));
+            }
+            QJsonObject stage;
+            stage["count"] = static_cast<double>(count);
+            stage["totalNanoseconds"] = static_cast<double>(
+                histogram.total.load(std::memory_order_relaxed));
+            stage["maxNanoseconds"] = static_cast<double>(
+                histogram.max.load(std::memory_order_relaxed));
+            stage["p50Nanoseconds"] =
+                static_cast<double>(percentile(histogram, 0.50));
+            stage["p99Nanoseconds"] =
+                static_cast<double>(percentile(histogram, 0.99));
+            stage["buckets"] = buckets;
+            stages[STAGE_NAMES[j]] = stage;
+        }
+        if (!stages.isEmpty()) {
+            commands[name] = stages;
+        }
+    }
+
+    QJsonObject json;
+    json["elapsedNanoseconds"] = static_cast<double>(
+        now() - m_startTime.load(std::memory_order_relaxed));
+    json["commands"] = commands;
+    return json;
+}
+
+int CommandStats::bucketIndex(quint64 nanoseconds) {
+    if (nanoseconds < 2) {
+        return 0;
+    }
+    int index = 63 - qCountLeadingZeroBits(nanoseconds);
+    return index < NUM_BUCKETS ? index : NUM_BUCKETS - 1;
+}
+
+quint64 CommandStats::percentile(const Histogram& histogram, double fraction) {
+    // Returns the upper bound of the bucket containing the percentile, which
+    // overestimates by at most a factor of two
+    quint64 count = histogram.count.load(std::memory_order_relaxed);
+    quint64 cumulative = 0;
+    for (int i = 0; i < NUM_BUCKETS; i += 1) {
+        cumulative += histogram.buckets[i].load(std::memory_order_relaxed);
+        if (fraction * count <= cumulative) {
+            return quint64(1) << (i + 1);
+        }
+    }
+    return histogram.max.load(std::memory_order_relaxed);
+}
+
+QString CommandStats::formatDuration(quint64 nanoseconds) {
+    if (nanoseconds < 1000) {
+        return QString::number(nanoseconds) + " ns";
+    }
+    if (nanoseconds < 1000 * 1000) {
+        return QString::number(nanoseconds / 1e3, 'f', 1) + " us";
+    }
+    if (nanoseconds < 1000 * 1000 * 1000) {
+        return QString::number(nanoseconds / 1e6, 'f', 1) + " ms";
+    }
+    return QString::number(nanoseconds / 1e9, 'f', 1) + " s";
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+#include <atomic>
+
+#include "CommandParser.h"
+
+namespace mms {
+
+enum class CommandStage {
+    // From the algorithm's output arriving to the command being dispatched
+    ARRIVAL,
+    // Parsing and executing the command
+    HANDLER,
+    // Waiting in the command queue behind earlier commands
+    QUEUE,
+    // Animating the movement that the command started
+    ANIMATION,
+    // Writing the response back to the algorithm
+    RESPONSE,
+};
+
+// Per-command-type counters and latency histograms. Recording is lock-free
+// (just a few relaxed atomic increments), so the stats are always enabled, and
+// the histograms can be read from any thread while they're being written.
+class CommandStats {
+
+public:
+
+    CommandStats();
+
+    // Monotonic timestamp, in nanoseconds, for measuring durations
+    static qint64 now();
+
+    void record(CommandType type, CommandStage stage, qint64 nanoseconds);
+    void reset();
+
+    // A human-readable table of the nonempty histograms
+    QString toText() const;
+
+    // Everything, including the raw histogram buckets
+    QJsonObject toJson() const;
+
+private:
+
+    static const int NUM_STAGES = 5;
+    static const char* const STAGE_NAMES[NUM_STAGES];
+
+    // Bucket i holds durations in [2^i, 2^(i+1)) nanoseconds; the last bucket
+    // also holds anything longer than that
+    static const int NUM_BUCKETS = 40;
+
+    struct Histogram {
+        std::atomic<quint64> count;
+        std::atomic<quint64> total;
+        std::atomic<quint64> max;
+        std::atomic<quint64> buckets[NUM_BUCKETS];
+    };
+
+    std::atomic<qint64> m_startTime;
+    Histogram m_histograms[NUM_COMMAND_TYPES][NUM_STAGES];
+
+    static int bucketIndex(quint64 nanoseconds);
+    static quint64 percentile(const Histogram& histogram, double fraction);
+    static QString formatDuration(quint64 nanoseconds);
+};
+
+}
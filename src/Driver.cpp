@@ -1,10 +1,19 @@
 #include "Driver.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QStandardPaths>
+#include <QTextStream>
 
 #include "AssertMacros.h"
 #include "Logging.h"
 #include "Settings.h"
+#include "SettingsMazeFiles.h"
+#include "SettingsMouseAlgos.h"
+#include "Tournament.h"
+#include "Trace.h"
 #include "Window.h"
 
 namespace mms {
@@ -14,19 +23,107 @@ int Driver::drive(int argc, char* argv[]) {
     // Make sure that this function is called just once
     ASSERT_RUNS_JUST_ONCE();
 
+    // Tournaments don't need a window, or even a display
+    for (int i = 1; i < argc; i += 1) {
+        if (QString(argv[i]) == "--tournament") {
+            return tournament(argc, argv);
+        }
+    }
+
     // Initialize Qt
     QApplication app(argc, argv);
 
     // Initialize singletons
     Logging::init();
     Settings::init();
+    Trace::setThreadName("GUI");
 
     // Create the main window
     Window window;
     window.show();
 
     // Start the event loop
-    return app.exec();
+    int exitCode = app.exec();
+
+    // Write any settings changes that are still pending
+    Settings::get()->flush();
+
+    // Write any messages that are still queued
+    Logging::shutdown();
+    return exitCode;
+}
+
+int Driver::tournament(int argc, char* argv[]) {
+
+    QCoreApplication app(argc, argv);
+    Logging::init();
+    Settings::init();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Runs every mouse algorithm in every maze, without graphics, and "
+        "writes the ranked results to tournament.csv and tournament.json");
+    parser.addHelpOption();
+    QCommandLineOption tournamentOption(
+        "tournament",
+        "Run a tournament instead of opening the window");
+    QCommandLineOption generatedOption(
+        "generated",
+        "The number of generated mazes to include",
+        "count",
+        QString::number(Tournament::DEFAULT_GENERATED_MAZE_COUNT));
+    QCommandLineOption seedOption(
+        "seed",
+        "The seed of the generated mazes",
+        "seed",
+        "0");
+    parser.addOption(tournamentOption);
+    parser.addOption(generatedOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    // The settings and the log are flushed however the tournament ends
+    QString directory =
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    int exitCode = 1;
+    if (directory.isEmpty() || !QDir().mkpath(directory)) {
+        QTextStream(stdout)
+            << "Couldn't create the directory for the results" << endl;
+    }
+    else {
+        exitCode = runTournament(
+            directory,
+            parser.value(generatedOption).toInt(),
+            parser.value(seedOption).toULongLong());
+    }
+
+    Settings::get()->flush();
+    Logging::shutdown();
+    return exitCode;
+}
+
+int Driver::runTournament(
+        const QString& directory,
+        int generatedMazeCount,
+        quint64 seed) {
+
+    QTextStream out(stdout);
+    Tournament tournament(
+        SettingsMouseAlgos::names(),
+        SettingsMazeFiles::getAllPaths());
+    tournament.addGeneratedMazes(generatedMazeCount, seed);
+    if (!tournament.run(directory + "/tournament-cache.jsonl")) {
+        out << "Couldn't write the results cache" << endl;
+    }
+
+    QString csvPath = directory + "/tournament.csv";
+    QString jsonPath = directory + "/tournament.json";
+    if (!tournament.writeCsv(csvPath) || !tournament.writeJson(jsonPath)) {
+        out << "Couldn't write the results to " << directory << endl;
+        return 1;
+    }
+    out << "Results written to " << csvPath << " and " << jsonPath << endl;
+    return 0;
 }
 
-} 
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <QString>
+#include <QtGlobal>
+
 namespace mms {
 
 class Driver {
@@ -8,6 +11,19 @@ public:
     Driver() = delete;
     static int drive(int argc, char* argv[]);
 
+private:
+
+    // Runs a tournament in place of the window:
+    //   mms --tournament [--generated <count>] [--seed <seed>]
+    static int tournament(int argc, char* argv[]);
+
+    // Runs the tournament and writes the results to the directory; returns
+    // the exit code
+    static int runTournament(
+        const QString& directory,
+        int generatedMazeCount,
+        quint64 seed);
+
 };
 
 } 
@@ -17,7 +17,7 @@ QString FontImage::characters() {
 }
 
 
-QMap<QChar, QPair<double, double>> FontImage::positions() {
+const QMap<QChar, QPair<double, double>>& FontImage::positions() {
     static QMap<QChar, QPair<double, double>> map;
     if (map.isEmpty()) {
         // Map from char to fractional position in the image (from 0.0 to 1.0)
@@ -12,7 +12,7 @@ public:
     FontImage() = delete;
     static QString path();
     static QString characters();
-    static QMap<QChar, QPair<double, double>> positions();
+    static const QMap<QChar, QPair<double, double>>& positions();
 
 };
 
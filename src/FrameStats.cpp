@@ -0,0 +1,134 @@
+#include "FrameStats.h"
+
+#include <QFontDatabase>
+#include <QStringList>
+
+namespace mms {
+
+const int FrameStats::HISTORY_SIZE = 120;
+const qint64 FrameStats::TARGET_FRAME_NANOSECONDS = 1000 * 1000 * 1000 / 60;
+
+FrameStats::FrameStats() :
+    m_next(0) {
+    m_frames.reserve(HISTORY_SIZE);
+}
+
+void FrameStats::addFrame(const Frame& frame) {
+    if (m_frames.size() < HISTORY_SIZE) {
+        m_frames.append(frame);
+    }
+    else {
+        m_frames[m_next] = frame;
+    }
+    m_next = (m_next + 1) % HISTORY_SIZE;
+}
+
+void FrameStats::draw(QPainter* painter) const {
+
+    QVector<Frame> frames = getFrames();
+    if (frames.isEmpty()) {
+        return;
+    }
+
+    // Average everything over the history
+    double interval = 0.0;
+    double mouse = 0.0;
+    double upload = 0.0;
+    double draw = 0.0;
+    double gpu = 0.0;
+    double bytesUploaded = 0.0;
+    int gpuFrames = 0;
+    for (const Frame& frame : frames) {
+        interval += frame.interval;
+        mouse += frame.mouse;
+        upload += frame.upload;
+        draw += frame.draw;
+        bytesUploaded += frame.bytesUploaded;
+        if (0 <= frame.gpu) {
+            gpu += frame.gpu;
+            gpuFrames += 1;
+        }
+    }
+    double count = frames.size();
+    QStringList lines = {
+        QString("frame   %1 (%2 fps)").arg(
+            formatMilliseconds(interval / count),
+            QString::number(0 < interval ? 1e9 * count / interval : 0.0, 'f', 0)
+        ),
+        QString("mouse   %1").arg(formatMilliseconds(mouse / count)),
+        QString("upload  %1, %2 KB").arg(
+            formatMilliseconds(upload / count),
+            QString::number(bytesUploaded / count / 1024.0, 'f', 0)
+        ),
+        QString("draw    %1").arg(formatMilliseconds(draw / count)),
+        QString("gpu     %1").arg(
+            0 < gpuFrames ? formatMilliseconds(gpu / gpuFrames) : "n/a"
+        ),
+        QString("tris    %1").arg(frames.last().triangles),
+    };
+
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    font.setPointSize(9);
+    painter->setFont(font);
+    QFontMetrics metrics(font);
+    int lineHeight = metrics.height();
+    int textWidth = 0;
+    for (const QString& line : lines) {
+        // QFontMetrics::width is deprecated as of Qt 5.11
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        textWidth = qMax(textWidth, metrics.horizontalAdvance(line));
+#else
+        textWidth = qMax(textWidth, metrics.width(line));
+#endif
+    }
+
+    // The graph has one bar per frame, and is as wide as the history
+    int margin = 6;
+    int graphHeight = 60;
+    int width = qMax(textWidth, HISTORY_SIZE * 2) + 2 * margin;
+    int height = lines.size() * lineHeight + graphHeight + 3 * margin;
+    painter->fillRect(0, 0, width, height, QColor(0, 0, 0, 180));
+
+    painter->setPen(Qt::white);
+    for (int i = 0; i < lines.size(); i += 1) {
+        painter->drawText(
+            margin,
+            margin + i * lineHeight + metrics.ascent(),
+            lines.at(i));
+    }
+
+    // Bars are scaled so that twice the target frame time fills the graph,
+    // and are red if they missed the target
+    int graphTop = 2 * margin + lines.size() * lineHeight;
+    int graphBottom = graphTop + graphHeight;
+    double scale = graphHeight / (2.0 * TARGET_FRAME_NANOSECONDS);
+    for (int i = 0; i < frames.size(); i += 1) {
+        int barHeight = qMin(
+            graphHeight,
+            static_cast<int>(frames.at(i).interval * scale));
+        painter->fillRect(
+            margin + 2 * i,
+            graphBottom - barHeight,
+            2,
+            barHeight,
+            TARGET_FRAME_NANOSECONDS < frames.at(i).interval ?
+                QColor(255, 80, 80) :
+                QColor(100, 220, 100));
+    }
+    int targetY = graphBottom - static_cast<int>(TARGET_FRAME_NANOSECONDS * scale);
+    painter->setPen(QColor(255, 255, 255, 120));
+    painter->drawLine(margin, targetY, width - margin, targetY);
+}
+
+QVector<Frame> FrameStats::getFrames() const {
+    if (m_frames.size() < HISTORY_SIZE) {
+        return m_frames;
+    }
+    return m_frames.mid(m_next) + m_frames.mid(0, m_next);
+}
+
+QString FrameStats::formatMilliseconds(double nanoseconds) {
+    return QString::number(nanoseconds / 1e6, 'f', 2) + " ms";
+}
+
+}
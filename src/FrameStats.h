@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QPainter>
+#include <QVector>
+
+namespace mms {
+
+// The cost of drawing a single frame. Times are in nanoseconds; the GPU time
+// is -1 if it's not (yet) known.
+struct Frame {
+    qint64 interval;
+    qint64 mouse;
+    qint64 upload;
+    qint64 draw;
+    qint64 gpu;
+    qint64 bytesUploaded;
+    int triangles;
+};
+
+// A rolling history of frames, which can draw itself as an overlay of
+// averages and a graph of recent frame times
+class FrameStats {
+
+public:
+
+    FrameStats();
+
+    void addFrame(const Frame& frame);
+    void draw(QPainter* painter) const;
+
+private:
+
+    static const int HISTORY_SIZE;
+    static const qint64 TARGET_FRAME_NANOSECONDS;
+
+    QVector<Frame> m_frames;
+    int m_next;
+
+    // The frames in the history, oldest first
+    QVector<Frame> getFrames() const;
+
+    static QString formatMilliseconds(double nanoseconds);
+};
+
+}
@@ -1,31 +1,191 @@
 #include "Logging.h"
 
+#include <QByteArray>
+#include <QTextStream>
+
 #include "AssertMacros.h"
 
 namespace mms {
 
-QTextStream* Logging::STDOUT = nullptr;
+std::atomic<Logging::Record*> Logging::HEAD(&Logging::STUB);
+Logging::Record* Logging::TAIL = &Logging::STUB;
+Logging::Record Logging::STUB;
+
+std::atomic<int> Logging::LEVEL(0);
+std::atomic<bool> Logging::RUNNING(false);
+std::atomic<bool> Logging::STOPPING(false);
+std::atomic<bool> Logging::SLEEPING(false);
+std::mutex Logging::MUTEX;
+std::condition_variable Logging::WAKE;
+std::thread* Logging::WRITER = nullptr;
+std::mutex Logging::SHUTDOWN_MUTEX;
 
 void Logging::init() {
-    ASSERT_TR(STDOUT == nullptr);
-    STDOUT = new QTextStream(stdout);
+    ASSERT_TR(WRITER == nullptr);
+    QByteArray level = qgetenv("MMS_LOG_LEVEL").toLower();
+    if (level == "info") {
+        setLevel(QtInfoMsg);
+    }
+    else if (level == "warning") {
+        setLevel(QtWarningMsg);
+    }
+    else if (level == "critical") {
+        setLevel(QtCriticalMsg);
+    }
+    STUB.next.store(nullptr);
+    STOPPING.store(false);
+    RUNNING.store(true);
+    WRITER = new std::thread(run);
     qInstallMessageHandler(handler);
 }
 
+void Logging::shutdown() {
+    std::lock_guard<std::mutex> shutdownLock(SHUTDOWN_MUTEX);
+    if (WRITER != nullptr) {
+        RUNNING.store(false);
+        {
+            std::lock_guard<std::mutex> lock(MUTEX);
+            STOPPING.store(true);
+        }
+        WAKE.notify_one();
+        WRITER->join();
+        delete WRITER;
+        WRITER = nullptr;
+    }
+    // Catch anything pushed while the writer was stopping
+    write();
+}
+
+void Logging::setLevel(QtMsgType level) {
+    LEVEL.store(severity(level), std::memory_order_relaxed);
+}
+
 void Logging::handler(
     QtMsgType type,
     const QMessageLogContext& context,
     const QString& msg) {
 
-    ASSERT_FA(STDOUT == nullptr);
-    
-    QString formatted = QString("[%1:%2] - %3").arg(
-        context.file,
-        QString::number(context.line),
-        msg
-    );
+    // Fatal messages are always written, since the process is about to abort
+    if (
+        type != QtFatalMsg &&
+        severity(type) < LEVEL.load(std::memory_order_relaxed)
+    ) {
+        return;
+    }
+
+    Record* record = new Record();
+    record->type = type;
+    // The file is a string literal, so it outlives the record
+    record->file = context.file;
+    record->line = context.line;
+    record->message = msg;
+
+    push(record);
+    if (type == QtFatalMsg || !RUNNING.load()) {
+        // Write everything before returning, since nothing else will
+        shutdown();
+        return;
+    }
+    if (SLEEPING.load()) {
+        std::lock_guard<std::mutex> lock(MUTEX);
+        WAKE.notify_one();
+    }
+}
+
+int Logging::severity(QtMsgType type) {
+    switch (type) {
+        case QtDebugMsg:
+            return 0;
+        case QtInfoMsg:
+            return 1;
+        case QtWarningMsg:
+            return 2;
+        case QtCriticalMsg:
+            return 3;
+        case QtFatalMsg:
+            return 4;
+    }
+    return 4;
+}
+
+void Logging::push(Record* record) {
+    record->next.store(nullptr, std::memory_order_relaxed);
+    Record* previous = HEAD.exchange(record);
+    // Until this store, the record is invisible to the writer thread
+    previous->next.store(record);
+}
+
+Logging::Record* Logging::pop() {
+
+    // Only ever called by one thread at a time
+    Record* tail = TAIL;
+    Record* next = tail->next.load();
+    if (tail == &STUB) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        TAIL = next;
+        tail = next;
+        next = next->next.load();
+    }
+    if (next != nullptr) {
+        TAIL = next;
+        return tail;
+    }
+
+    // The tail is the last record; a producer might be partway through a push
+    if (tail != HEAD.load()) {
+        return nullptr;
+    }
+
+    // Put the stub back at the head, so that the tail can be returned
+    push(&STUB);
+    next = tail->next.load();
+    if (next != nullptr) {
+        TAIL = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+bool Logging::isEmpty() {
+    return TAIL == &STUB && STUB.next.load() == nullptr;
+}
+
+void Logging::write() {
+    QTextStream stream(stdout);
+    Record* record = pop();
+    if (record == nullptr) {
+        return;
+    }
+    while (record != nullptr) {
+        stream << QString("[%1:%2] - %3\n").arg(
+            record->file,
+            QString::number(record->line),
+            record->message
+        );
+        delete record;
+        record = pop();
+    }
+    // One flush per batch, rather than per message
+    stream.flush();
+}
 
-    *STDOUT << formatted << endl;
+void Logging::run() {
+    while (true) {
+        // Read the flag first, so that the final write can't miss anything
+        bool isStopping = STOPPING.load();
+        write();
+        if (isStopping) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(MUTEX);
+        SLEEPING.store(true);
+        WAKE.wait(lock, [](){
+            return STOPPING.load() || !isEmpty();
+        });
+        SLEEPING.store(false);
+    }
 }
 
 } 
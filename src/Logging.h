@@ -2,22 +2,74 @@
 
 #include <QDebug>
 #include <QString>
-#include <QTextStream>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace mms {
 
+// Qt messages are handed off to a background thread, which formats them and
+// writes them to stdout in batches, so that logging never blocks the caller
+// on I/O. Messages below the level are dropped before anything else is done.
 class Logging {
 
 public:
+
+    // The Logging class is not constructible
     Logging() = delete;
+
+    // Installs the message handler and starts the writer thread. The level can
+    // be set with the MMS_LOG_LEVEL environment variable, to one of "debug"
+    // (the default), "info", "warning", or "critical".
     static void init();
 
+    // Stops the writer thread, if it's running, and writes any pending
+    // messages; messages logged afterwards are written immediately
+    static void shutdown();
+
+    static void setLevel(QtMsgType level);
+
 private:
-    static QTextStream* STDOUT;
+
+    // A message, as it was logged; it's formatted by the writer thread
+    struct Record {
+        std::atomic<Record*> next;
+        QtMsgType type;
+        const char* file;
+        int line;
+        QString message;
+    };
+
+    // An intrusive multiple-producer, single-consumer queue: producers swap
+    // themselves in at the head, and the writer thread pops from the tail
+    static std::atomic<Record*> HEAD;
+    static Record* TAIL;
+    static Record STUB;
+
+    static std::atomic<int> LEVEL;
+    static std::atomic<bool> RUNNING;
+    static std::atomic<bool> STOPPING;
+    static std::atomic<bool> SLEEPING;
+    static std::mutex MUTEX;
+    static std::condition_variable WAKE;
+    static std::thread* WRITER;
+
+    // Held while stopping the writer thread, or while writing on its behalf
+    static std::mutex SHUTDOWN_MUTEX;
+
     static void handler(
         QtMsgType type,
         const QMessageLogContext& context,
         const QString& msg);
+
+    static int severity(QtMsgType type);
+    static void push(Record* record);
+    static Record* pop();
+    static bool isEmpty();
+    static void write();
+    static void run();
 };
 
 } 
@@ -2,28 +2,33 @@
 
 #include <QElapsedTimer>
 #include <QFile>
+#include <QOpenGLTimerQuery>
 
 #include "AssertMacros.h"
 #include "Dimensions.h"
 #include "FontImage.h"
 #include "Logging.h"
+#include "TraceMacros.h"
 #include "TransformationMatrix.h"
 
 namespace mms {
 
+const int Map::NUM_TIMER_QUERIES = 3;
+
 Map::Map(QWidget* parent) :
     QOpenGLWidget(parent),
     m_maze(nullptr),
     m_view(nullptr),
-    m_mouseGraphic(nullptr),
     m_windowWidth(0),
     m_windowHeight(0),
-    m_textureAtlas(nullptr) {
+    m_textureAtlas(nullptr),
+    m_showFrameStats(false),
+    m_timerQueryCount(0) {
     ASSERT_RUNS_JUST_ONCE();
 }
 
 void Map::setMaze(const Maze* maze) {
-    ASSERT_TR(m_mouseGraphic == nullptr);
+    ASSERT_TR(m_mouseGraphics.isEmpty());
     m_maze = maze;
     m_view = nullptr;
 }
@@ -35,12 +40,12 @@ void Map::setView(const MazeView* view) {
     m_view = view;
 }
 
-void Map::setMouseGraphic(const MouseGraphic* mouseGraphic) {
-    if (mouseGraphic != nullptr) {
+void Map::setMouseGraphics(const QVector<const MouseGraphic*>& mouseGraphics) {
+    if (!mouseGraphics.isEmpty()) {
         ASSERT_FA(m_maze == nullptr);
         ASSERT_FA(m_view == nullptr);
     }
-    m_mouseGraphic = mouseGraphic;
+    m_mouseGraphics = mouseGraphics;
 }
 
 QStringList Map::getOpenGLVersionInfo() {
@@ -67,6 +72,10 @@ QStringList Map::getOpenGLVersionInfo() {
     return info;
 }
 
+void Map::toggleFrameStats() {
+    m_showFrameStats = !m_showFrameStats;
+}
+
 void Map::shutdown() {
     makeCurrent();
     m_openGLLogger.stopLogging();
@@ -74,7 +83,18 @@ void Map::shutdown() {
 
 void Map::initOpenGLLogger() {
     if (m_openGLLogger.initialize()) {
-        m_openGLLogger.startLogging(QOpenGLDebugLogger::SynchronousLogging);
+        // Messages may arrive on a driver thread; the message handler doesn't
+        // care which thread it's called from
+        connect(
+            &m_openGLLogger,
+            &QOpenGLDebugLogger::messageLogged,
+            this,
+            [](const QOpenGLDebugMessage& message){
+                qWarning() << message;
+            },
+            Qt::DirectConnection
+        );
+        m_openGLLogger.startLogging(QOpenGLDebugLogger::AsynchronousLogging);
         m_openGLLogger.enableMessages();
         m_openGLLogger.disableMessages(
             QOpenGLDebugMessage::AnySource,
@@ -102,15 +122,16 @@ void Map::initializeGL() {
     // Initialize the polygon and texture programs
     initPolygonProgram();
     initTextureProgram();
+    initTimerQueries();
 }
 
 void Map::paintGL() {
 
-    // TODO: upforgrabs
-    // Optimize this code
-    //
-    // QElapsedTimer timer;
-    // timer.start();
+    TRACE_SCOPE("Map::paintGL");
+
+    // The time between frames is the frame time that the user sees
+    qint64 interval = m_frameTimer.isValid() ? m_frameTimer.nsecsElapsed() : 0;
+    m_frameTimer.start();
 
     // If the view hasn't been set yet, just draw black
     if (m_view == nullptr) {
@@ -118,13 +139,26 @@ void Map::paintGL() {
         return;
     }
 
-    QVector<TriangleGraphic> mouseBuffer;
-    if (m_mouseGraphic != nullptr) {
-        mouseBuffer = m_mouseGraphic->draw();
+    QElapsedTimer timer;
+    timer.start();
+
+    // Note that clear() keeps the capacity of the buffer
+    m_mouseBuffer.clear();
+    for (const MouseGraphic* mouseGraphic : m_mouseGraphics) {
+        mouseGraphic->draw(&m_mouseBuffer);
     }
+    qint64 mouse = timer.nsecsElapsed();
 
     // Re-populate both vertex buffer objects
-    repopulateVertexBufferObjects(mouseBuffer);
+    qint64 bytesUploaded = repopulateVertexBufferObjects(m_mouseBuffer);
+    qint64 upload = timer.nsecsElapsed() - mouse;
+
+    // Only time the GPU while the stats are visible
+    QOpenGLTimerQuery* timerQuery = nullptr;
+    qint64 gpu = -1;
+    if (m_showFrameStats) {
+        timerQuery = beginTimerQuery(&gpu);
+    }
 
     // Draw the tiles
     drawMap(
@@ -144,18 +178,39 @@ void Map::paintGL() {
         );
     }
 
-    // Draw the mouse
+    // Draw all of the mice at once
     drawMap(
         &m_polygonProgram,
         &m_polygonVAO,
         3 * m_view->getGraphicCpuBuffer()->size(),
-        3 * mouseBuffer.size()
+        3 * m_mouseBuffer.size()
     );
 
-    // TODO: upforgrabs
-    // Optimize this code
-    //
-    // qDebug() << timer.nsecsElapsed();
+    if (timerQuery != nullptr) {
+        timerQuery->end();
+    }
+    qint64 draw = timer.nsecsElapsed() - mouse - upload;
+
+    m_frameStats.addFrame({
+        interval,
+        mouse,
+        upload,
+        draw,
+        gpu,
+        bytesUploaded,
+        m_view->getGraphicCpuBuffer()->size() +
+        m_view->getTextureCpuBuffer()->size() +
+        m_mouseBuffer.size(),
+    });
+
+    if (m_showFrameStats) {
+        QPainter painter(this);
+        m_frameStats.draw(&painter);
+        painter.end();
+        // The painter doesn't restore the blending that the map relies on
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
 }
 
 void Map::resizeGL(int width, int height) {
@@ -290,7 +345,43 @@ void Map::initTextureProgram() {
     m_polygonProgram.release();
 }
 
-void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuffer) {
+void Map::initTimerQueries() {
+#if !defined(QT_OPENGL_ES_2)
+    for (int i = 0; i < NUM_TIMER_QUERIES; i += 1) {
+        QOpenGLTimerQuery* timerQuery = new QOpenGLTimerQuery(this);
+        // Not all drivers support timer queries
+        if (!timerQuery->create()) {
+            delete timerQuery;
+            break;
+        }
+        m_timerQueries.append(timerQuery);
+    }
+#endif
+}
+
+QOpenGLTimerQuery* Map::beginTimerQuery(qint64* previousResult) {
+#if !defined(QT_OPENGL_ES_2)
+    if (m_timerQueries.size() < NUM_TIMER_QUERIES) {
+        return nullptr;
+    }
+    // The queries are used round robin, and the result of this one is from a
+    // few frames ago, so it's probably available without waiting for the GPU
+    QOpenGLTimerQuery* timerQuery =
+        m_timerQueries.at(m_timerQueryCount % NUM_TIMER_QUERIES);
+    if (NUM_TIMER_QUERIES <= m_timerQueryCount && timerQuery->isResultAvailable()) {
+        *previousResult = timerQuery->waitForResult();
+    }
+    m_timerQueryCount += 1;
+    timerQuery->begin();
+    return timerQuery;
+#else
+    return nullptr;
+#endif
+}
+
+qint64 Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuffer) {
+
+    TRACE_SCOPE("Map::repopulateVertexBufferObjects");
 
     // Overwrite the polygon vertex buffer object data
     m_polygonVBO.bind();
@@ -304,7 +395,7 @@ void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuf
         &(m_view->getGraphicCpuBuffer()->front()),
         sizeof(TriangleGraphic) * m_view->getGraphicCpuBuffer()->size()
     );
-    // Write the mouse
+    // Write the mice
     if (!mouseBuffer.isEmpty()) {
         m_polygonVBO.write(
             sizeof(TriangleGraphic) * m_view->getGraphicCpuBuffer()->size(),
@@ -321,6 +412,14 @@ void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuf
         sizeof(TriangleTexture) * m_view->getTextureCpuBuffer()->size()
     );
     m_textureVBO.release();
+
+    return (
+        sizeof(TriangleGraphic) * (
+            m_view->getGraphicCpuBuffer()->size() +
+            mouseBuffer.size()
+        ) +
+        sizeof(TriangleTexture) * m_view->getTextureCpuBuffer()->size()
+    );
 }
 
 void Map::drawMap(
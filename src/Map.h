@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QElapsedTimer>
 #include <QOpenGLBuffer> 
 #include <QOpenGLDebugLogger>
 #include <QOpenGLFunctions>
@@ -9,11 +10,14 @@
 #include <QOpenGLWidget>
 #include <QVector>
 
+#include "FrameStats.h"
 #include "Maze.h"
 #include "MazeView.h"
 #include "MouseGraphic.h"
 #include "TriangleGraphic.h"
 
+class QOpenGLTimerQuery;
+
 namespace mms {
 
 class Map : public QOpenGLWidget, protected QOpenGLFunctions {
@@ -29,11 +33,16 @@ public:
 
     void setMaze(const Maze* maze);
     void setView(const MazeView* view);
-    void setMouseGraphic(const MouseGraphic* mouseGraphic);
+
+    // All of the mice are drawn on top of the view, in a single batch
+    void setMouseGraphics(const QVector<const MouseGraphic*>& mouseGraphics);
 
     // Retrieves OpenGL version info
     QStringList getOpenGLVersionInfo();
 
+    // Shows or hides the frame times, upload sizes, and triangle counts
+    void toggleFrameStats();
+
     void shutdown();
 
 protected:
@@ -55,7 +64,10 @@ private:
     // No ownership here - only pointers
     const Maze* m_maze;
     const MazeView* m_view;
-    const MouseGraphic* m_mouseGraphic;
+    QVector<const MouseGraphic*> m_mouseGraphics;
+
+    // Reused from frame to frame, so that drawing the mice doesn't allocate
+    QVector<TriangleGraphic> m_mouseBuffer;
 
     // The map's window size, in pixels
     int m_windowWidth;
@@ -72,12 +84,27 @@ private:
     QOpenGLVertexArrayObject m_textureVAO;
     QOpenGLBuffer m_textureVBO;
 
+    // Frame stats, recorded every frame and drawn on top of the map
+    bool m_showFrameStats;
+    FrameStats m_frameStats;
+    QElapsedTimer m_frameTimer;
+
+    // GPU timer queries, empty if they're not supported
+    static const int NUM_TIMER_QUERIES;
+    QVector<QOpenGLTimerQuery*> m_timerQueries;
+    int m_timerQueryCount;
+
     // Initialize the graphics
     void initPolygonProgram();
     void initTextureProgram();
+    void initTimerQueries();
+
+    // Begins a timer query, if supported, and gets the GPU time of an earlier
+    // frame if it's available
+    QOpenGLTimerQuery* beginTimerQuery(qint64* previousResult);
 
-    // Drawing helper methods
-    void repopulateVertexBufferObjects(
+    // Drawing helper methods, returns the number of bytes uploaded
+    qint64 repopulateVertexBufferObjects(
         const QVector<TriangleGraphic>& mouseBuffer);
     void drawMap(
         QOpenGLShaderProgram* program,
@@ -2,21 +2,44 @@
 
 #include <QFile>
 #include <QTextStream>
-#include <QQueue>
 
 #include "AssertMacros.h"
+#include "MazeChecker.h"
+#include "TraceMacros.h"
 
 namespace mms {
 
 Maze* Maze::fromFile(const QString& path) {
+    TRACE_SCOPE("Maze::fromFile");
+    return fromWallGrid(readFile(path));
+}
+
+Maze* Maze::fromWallGrid(const WallGrid& grid) {
+    // A single pass performs both the validity and the official checks
+    MazeCheck check = MazeChecker::check(grid);
+    if (!check.isValid()) {
+        return nullptr;
+    }
+    return new Maze(grid, check);
+}
+
+WallGrid Maze::gridFromFile(const QString& path) {
+    WallGrid grid = readFile(path);
+    if (!MazeChecker::isValid(grid)) {
+        return WallGrid();
+    }
+    return grid;
+}
+
+WallGrid Maze::readFile(const QString& path) {
 
     // Open the file
     if (path.isEmpty()) {
-        return nullptr;
+        return WallGrid();
     }
     QFile file(path);
     if (!file.open(QFile::ReadOnly)) {
-        return nullptr;
+        return WallGrid();
     }
 
     // Read the lines into a vector
@@ -28,43 +51,56 @@ Maze* Maze::fromFile(const QString& path) {
     }
 
     // Try map format first, then num
-    Maze* maze = fromMapFile(lines);
-    if (maze != nullptr) {
-        return maze;
+    WallGrid grid = fromMapFile(lines);
+    if (!grid.isEmpty()) {
+        return grid;
     }
     return fromNumFile(lines);
 }
 
 int Maze::getWidth() const {
-    return m_tiles.size();
+    return m_grid.getWidth();
 }
 
 int Maze::getHeight() const {
-    return m_tiles.at(0).size();
+    return m_grid.getHeight();
 }
 
-const Tile* Maze::getTile(int x, int y) const {
+bool Maze::isWall(int x, int y, Direction direction) const {
     ASSERT_LE(0, x);
     ASSERT_LE(0, y);
     ASSERT_LT(x, getWidth());
     ASSERT_LT(y, getHeight());
-    return &m_tiles.at(x).at(y);
+    return m_grid.isWall(x, y, direction);
 }
 
-Maze::Maze(BasicMaze basicMaze) {
-    QVector<QVector<int>> distances = getDistances(basicMaze);
-    for (int x = 0; x < basicMaze.size(); x += 1) {
-        QVector<Tile> column;
-        for (int y = 0; y < basicMaze.at(x).size(); y += 1) {
-            Tile tile(x, y, distances.at(x).at(y), basicMaze.at(x).at(y));
-            tile.initPolygons(basicMaze.size(), basicMaze.at(x).size());
-            column.append(tile);
-        }
-        m_tiles.append(column);
-    }
+int Maze::getDistance(int x, int y) const {
+    ASSERT_LE(0, x);
+    ASSERT_LE(0, y);
+    ASSERT_LT(x, getWidth());
+    ASSERT_LT(y, getHeight());
+    return m_distances.at(m_grid.getIndex(x, y));
+}
+
+bool Maze::isOfficial() const {
+    return m_check.isOfficial();
+}
+
+QStringList Maze::getFailedOfficialChecks() const {
+    return m_check.getFailedOfficialChecks();
+}
+
+const WallGrid& Maze::getWallGrid() const {
+    return m_grid;
+}
+
+Maze::Maze(const WallGrid& grid, const MazeCheck& check) :
+    m_grid(grid),
+    m_distances(getDistances(grid)),
+    m_check(check) {
 }
 
-Maze* Maze::fromMapFile(QVector<QString> lines) {
+WallGrid Maze::fromMapFile(QVector<QString> lines) {
     // Format:
     //
     //     +---+---+---+
@@ -88,12 +124,10 @@ Maze* Maze::fromMapFile(QVector<QString> lines) {
 
             // Fill out the maze as necessary
             while (basicMaze.size() <= x) {
-                QVector<QMap<Direction, bool>> column;
-                basicMaze.append(column);
+                basicMaze.append(QVector<unsigned char>());
             }
             while (basicMaze.at(x).size() <= y) {
-                QMap<Direction, bool> walls;
-                basicMaze[x].append(walls);
+                basicMaze[x].append(0);
             }
 
             // Calculate the edges of the cell:
@@ -111,31 +145,26 @@ Maze* Maze::fromMapFile(QVector<QString> lines) {
 
             // Check bounds
             if (lines.size() <= north) {
-                return nullptr;
+                return WallGrid();
             }
             if (lines.at(south + 1).size() <= east) {
-                return nullptr;
+                return WallGrid();
             }
 
             // Add values for the current cell
-            QMap<Direction, bool> walls;
-            walls[Direction::NORTH] = lines.at(north).at(west + 2) != ' ';
-            walls[Direction::EAST]  = lines.at(south + 1).at(east) != ' ';
-            walls[Direction::SOUTH] = lines.at(south).at(west + 2) != ' ';
-            walls[Direction::WEST]  = lines.at(south + 1).at(west) != ' ';
-            basicMaze[x][y] = walls;
+            basicMaze[x][y] = packWalls(
+                lines.at(north).at(west + 2) != ' ',
+                lines.at(south + 1).at(east) != ' ',
+                lines.at(south).at(west + 2) != ' ',
+                lines.at(south + 1).at(west) != ' '
+            );
         }
     }
 
-    // Check if the maze is valid
-    if (!isValid(basicMaze)) {
-        return nullptr;
-    }
-
-    return new Maze(basicMaze);
+    return toWallGrid(basicMaze);
 }
 
-Maze* Maze::fromNumFile(QVector<QString> lines) {
+WallGrid Maze::fromNumFile(QVector<QString> lines) {
     // Format:
     //
     //     X Y N E S W
@@ -163,7 +192,7 @@ Maze* Maze::fromNumFile(QVector<QString> lines) {
         // Tokenize the line
         QStringList tokens = line.split(" ", QString::SkipEmptyParts);
         if (tokens.size() != 6) {
-            return nullptr;
+            return WallGrid();
         }
 
         // Extract numeric values
@@ -175,43 +204,41 @@ Maze* Maze::fromNumFile(QVector<QString> lines) {
         bool s = tokens.at(4).toInt(&ok) == 1;
         bool w = tokens.at(5).toInt(&ok) == 1;
         if (!ok) {
-            return nullptr;
+            return WallGrid();
         }
 
         // Fill out the maze as necessary
         while (basicMaze.size() <= x) {
-            QVector<QMap<Direction, bool>> column;
-            basicMaze.append(column);
+            basicMaze.append(QVector<unsigned char>());
         }
         while (basicMaze.at(x).size() <= y) {
-            QMap<Direction, bool> walls;
-            basicMaze[x].append(walls);
+            basicMaze[x].append(0);
         }
 
         // Add values for the current cell
-        QMap<Direction, bool> walls;
-        walls[Direction::NORTH] = n;
-        walls[Direction::EAST] = e;
-        walls[Direction::SOUTH] = s;
-        walls[Direction::WEST] = w;
-        basicMaze[x][y] = walls;
+        basicMaze[x][y] = packWalls(n, e, s, w);
     }
 
-    // Check if the maze is valid
-    if (!isValid(basicMaze)) {
-        return nullptr;
+    return toWallGrid(basicMaze);
+}
+
+WallGrid Maze::toWallGrid(const BasicMaze& basicMaze) {
+
+    // The grid can only represent nonempty, rectangular mazes
+    if (!isNonempty(basicMaze) || !isRectangular(basicMaze)) {
+        return WallGrid();
     }
 
-    return new Maze(basicMaze);
-}
+    // Copy the walls into the compact representation
+    WallGrid grid(basicMaze.size(), basicMaze.at(0).size());
+    for (int x = 0; x < grid.getWidth(); x += 1) {
+        for (int y = 0; y < grid.getHeight(); y += 1) {
+            grid.setWalls(x, y, basicMaze.at(x).at(y));
+        }
+    }
 
-bool Maze::isValid(const BasicMaze& basicMaze) {
-    return (
-        isNonempty(basicMaze) &&
-        isRectangular(basicMaze) &&
-        isEnclosed(basicMaze) &&
-        isConsistent(basicMaze)
-    );
+    // The rest of the validation happens on the grid, by the caller
+    return grid;
 }
 
 bool Maze::isNonempty(const BasicMaze& basicMaze) {
@@ -227,146 +254,49 @@ bool Maze::isRectangular(const BasicMaze& basicMaze) {
     return true;
 }
 
-bool Maze::isEnclosed(const BasicMaze& basicMaze) {
-    int width = basicMaze.size();
-    int height = basicMaze.at(0).size();
-    for (int x = 0; x < width; x += 1) {
-        for (int y = 0; y < height; y += 1) {
-            QMap<Direction, bool> walls = basicMaze.at(x).at(y);
-            if (x == 0 && !walls.value(Direction::WEST)) {
-                return false;
-            }
-            if (y == 0 && !walls.value(Direction::SOUTH)) {
-                return false;
-            }
-            if (x == width - 1 && !walls.value(Direction::EAST)) {
-                return false;
-            }
-            if (y == height - 1 && !walls.value(Direction::NORTH)) {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
-bool Maze::isConsistent(const BasicMaze& basicMaze) {
-    int width = basicMaze.size();
-    int height = basicMaze.at(0).size();
-    for (int x = 0; x < basicMaze.size(); x += 1) {
-        for (int y = 0; y < basicMaze.at(x).size(); y += 1) {
-            QMap<Direction, bool> walls = basicMaze.at(x).at(y);
-            if (
-                0 < x &&
-                walls.value(Direction::WEST) &&
-                !basicMaze.at(x - 1).at(y).value(Direction::EAST)
-            ) {
-                return false;
-            }
-            if (
-                0 < y &&
-                walls.value(Direction::SOUTH) &&
-                !basicMaze.at(x).at(y - 1).value(Direction::NORTH)
-            ) {
-                return false;
-            }
-            if (
-                x < width - 1 &&
-                walls.value(Direction::EAST) &&
-                !basicMaze.at(x + 1).at(y).value(Direction::WEST)
-            ) {
-                return false;
-            }
-            if (
-                y < height - 1 &&
-                walls.value(Direction::NORTH) &&
-                !basicMaze.at(x).at(y + 1).value(Direction::SOUTH)
-            ) {
-                return false;
-            }
-        }
-    }
-    return true;
+unsigned char Maze::packWalls(bool north, bool east, bool south, bool west) {
+    return (
+        (north ? WallGrid::bit(Direction::NORTH) : 0) |
+        (east ? WallGrid::bit(Direction::EAST) : 0) |
+        (south ? WallGrid::bit(Direction::SOUTH) : 0) |
+        (west ? WallGrid::bit(Direction::WEST) : 0)
+    );
 }
 
-QVector<QVector<int>> Maze::getDistances(BasicMaze basicMaze) {
+QVector<int> Maze::getDistances(const WallGrid& grid) {
 
     // Initialize all positions with default value
-    QVector<QVector<int>> distances;
-    for (int x = 0; x < basicMaze.size(); x += 1) {
-        QVector<int> column;
-        for (int y = 0; y < basicMaze.at(x).size(); y += 1) {
-            column.append(-1);
-        }
-        distances.append(column);
+    int height = grid.getHeight();
+    QVector<int> distances(grid.getWidth() * height, -1);
+
+    // Set the distances of the center positions to 0 and enqueue them. Every
+    // tile is enqueued at most once, so a flat vector can serve as the queue.
+    QVector<int> discovered;
+    discovered.reserve(distances.size());
+    for (QPair<int, int> position : grid.getCenterPositions()) {
+        int index = grid.getIndex(position.first, position.second);
+        distances[index] = 0;
+        discovered.append(index);
     }
 
-    // Set the distances of the center positions to 0 and enqueue them
-    QQueue<QPair<int, int>> discovered;
-    int width = basicMaze.size();
-    int height = basicMaze.at(0).size();
-    for (QPair<int, int> position : getCenterPositions(width, height)) {
-        distances[position.first][position.second] = 0;
-        discovered.enqueue(position);
-    }
-
-    // Perform a breadth first search
-    while (!discovered.empty()){
-        QPair<int, int> position = discovered.dequeue();
-        int x = position.first;
-        int y = position.second;
-        for (Direction direction : DIRECTIONS()) {
-            if (!basicMaze.at(x).at(y).value(direction)) {
-                int nx = x;
-                int ny = y;
-                if (direction == Direction::NORTH) {
-                    ny += 1;
-                }
-                if (direction == Direction::EAST) {
-                    nx += 1;
-                }
-                if (direction == Direction::SOUTH) {
-                    ny -= 1;
-                }
-                if (direction == Direction::WEST) {
-                    nx -= 1;
-                }
-                if (distances.at(nx).at(ny) == -1) {
-                    distances[nx][ny] = distances.at(x).at(y) + 1;
-                    discovered.enqueue({nx, ny});
-                }
+    // Perform a breadth first search, where the neighbor in each direction
+    // is a fixed offset away in the flat, column-major representation
+    const unsigned char* walls = grid.data();
+    const int offsets[] = {1, height, -1, -height};
+    for (int i = 0; i < discovered.size(); i += 1) {
+        int index = discovered.at(i);
+        for (int d = 0; d < 4; d += 1) {
+            if (walls[index] & (1 << d)) {
+                continue;
+            }
+            int neighbor = index + offsets[d];
+            if (distances.at(neighbor) == -1) {
+                distances[neighbor] = distances.at(index) + 1;
+                discovered.append(neighbor);
             }
         }
     }
     return distances;
 }
 
-QVector<QPair<int, int>> Maze::getCenterPositions(int width, int height) {
-
-    // +---+---+
-    // | C | D |
-    // +---+---+
-    // | A | B |
-    // +---+---+
-    QPair<int, int> A = {(width - 1) / 2, (height - 1) / 2};
-    QPair<int, int> B = {width / 2, (height - 1) / 2};
-    QPair<int, int> C = {(width - 1) / 2, height / 2};
-    QPair<int, int> D = {width / 2, height / 2};
-
-    QVector<QPair<int, int>> positions;
-    positions.append(A);
-    if (width % 2 == 0 && height % 2 == 0) {
-        positions.append(B);
-        positions.append(C);
-        positions.append(D);
-    }
-    else if (width % 2 == 0) {
-        positions.append(B);
-    }
-    else if (height % 2 == 0) {
-        positions.append(C);
-    }
-    return positions; 
-}
-
 } 
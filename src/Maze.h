@@ -3,11 +3,14 @@
 #include <QString>
 #include <QVector>
 
-#include "Tile.h"
+#include "Direction.h"
+#include "MazeChecker.h"
+#include "WallGrid.h"
 
 namespace mms {
 
-typedef QVector<QVector<QMap<Direction, bool>>> BasicMaze;
+// Walls of each tile, packed as in WallGrid, indexed by x and then y
+typedef QVector<QVector<unsigned char>> BasicMaze;
 
 class Maze {
 
@@ -15,29 +18,53 @@ public:
 
     static Maze* fromFile(const QString& path);
 
+    // Builds a maze from a grid, e.g., one made by the MazeGenerator, returns
+    // nullptr if the grid isn't a valid maze
+    static Maze* fromWallGrid(const WallGrid& grid);
+
+    // Reads and validates a maze file without computing distances,
+    // returns an empty grid if the file isn't a valid maze
+    static WallGrid gridFromFile(const QString& path);
+
     int getWidth() const;
     int getHeight() const;
-    const Tile* getTile(int x, int y) const;
+    bool isWall(int x, int y, Direction direction) const;
+
+    // The number of tiles between a tile and the center, or -1 if the center
+    // isn't reachable from the tile
+    int getDistance(int x, int y) const;
+
+    // Whether or not the maze complies with the official rules, and if not,
+    // which of them it breaks
+    bool isOfficial() const;
+    QStringList getFailedOfficialChecks() const;
+    const WallGrid& getWallGrid() const;
+
+    // The distance of each tile to the center, indexed as in the WallGrid
+    static QVector<int> getDistances(const WallGrid& grid);
 
 private:
 
-    QVector<QVector<Tile>> m_tiles;
-    explicit Maze(BasicMaze basicMaze);
+    // Only the walls and distances are stored; the geometry of each tile is
+    // computed by the renderer, see TileGeometry
+    WallGrid m_grid;
+    QVector<int> m_distances;
+    MazeCheck m_check;
+    Maze(const WallGrid& grid, const MazeCheck& check);
+
+    // Reads a maze file without validating it, returns an empty grid if the
+    // file can't be read or isn't in either format
+    static WallGrid readFile(const QString& path);
 
     // Maze file formats
-    static Maze* fromMapFile(QVector<QString> lines);
-    static Maze* fromNumFile(QVector<QString> lines);
+    static WallGrid fromMapFile(QVector<QString> lines);
+    static WallGrid fromNumFile(QVector<QString> lines);
 
-    // Validate the maze
-    static bool isValid(const BasicMaze& basicMaze);
+    // Only checks the shape of the maze, which the grid must be able to hold
+    static WallGrid toWallGrid(const BasicMaze& basicMaze);
     static bool isNonempty(const BasicMaze& basicMaze);
     static bool isRectangular(const BasicMaze& basicMaze);
-    static bool isEnclosed(const BasicMaze& basicMaze);
-    static bool isConsistent(const BasicMaze& basicMaze);
-
-    // Populate distances
-    static QVector<QVector<int>> getDistances(BasicMaze basicMaze);
-    static QVector<QPair<int, int>> getCenterPositions(int width, int height);
+    static unsigned char packWalls(bool north, bool east, bool south, bool west);
 
 };
 
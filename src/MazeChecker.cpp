@@ -0,0 +1,270 @@
+#include "MazeChecker.h"
+
+#include "AssertMacros.h"
+
+namespace mms {
+
+bool MazeCheck::isValid() const {
+    return isNonempty && isEnclosed && isConsistent;
+}
+
+bool MazeCheck::isOfficial() const {
+    return (
+        isValid() &&
+        hasNoInaccessibleLocations &&
+        hasThreeStartingWalls &&
+        hasOneEntranceToCenter &&
+        hasHollowCenter &&
+        hasWallAttachedToEachNonCenterPost &&
+        isUnsolvableByWallFollower
+    );
+}
+
+QStringList MazeCheck::getFailedOfficialChecks() const {
+    QStringList failed;
+    if (!isValid()) {
+        return failed;
+    }
+    if (!hasNoInaccessibleLocations) {
+        failed.append("has inaccessible locations");
+    }
+    if (!hasThreeStartingWalls) {
+        failed.append("doesn't have exactly three starting walls");
+    }
+    if (!hasOneEntranceToCenter) {
+        failed.append("doesn't have only one entrance to the center");
+    }
+    if (!hasHollowCenter) {
+        failed.append("doesn't have a hollow center");
+    }
+    if (!hasWallAttachedToEachNonCenterPost) {
+        failed.append("has a peg without walls attached to it");
+    }
+    if (!isUnsolvableByWallFollower) {
+        failed.append("is solvable by a wall-following robot");
+    }
+    return failed;
+}
+
+MazeCheck MazeChecker::check(const WallGrid& grid) {
+
+    MazeCheck result = {};
+    result.isNonempty = !grid.isEmpty();
+    if (!result.isNonempty) {
+        return result;
+    }
+
+    const unsigned char N = WallGrid::bit(Direction::NORTH);
+    const unsigned char E = WallGrid::bit(Direction::EAST);
+    const unsigned char S = WallGrid::bit(Direction::SOUTH);
+    const unsigned char W = WallGrid::bit(Direction::WEST);
+
+    int width = grid.getWidth();
+    int height = grid.getHeight();
+    const unsigned char* walls = grid.data();
+
+    // If the center is four tiles, the post in the middle of them is the only
+    // post that is allowed to have no walls attached to it
+    QVector<QPair<int, int>> centerPositions = grid.getCenterPositions();
+    QPair<int, int> centerPost = {-1, -1};
+    if (centerPositions.size() == 4) {
+        centerPost = centerPositions.at(0);
+    }
+
+    // Every tile starts out in its own region
+    QVector<int> regions(width * height);
+    int* parents = regions.data();
+    for (int i = 0; i < regions.size(); i += 1) {
+        parents[i] = i;
+    }
+    int numRegions = regions.size();
+
+    // The single pass: each tile is compared only with its east and north
+    // neighbors, so that every wall is looked at exactly once
+    result.isEnclosed = true;
+    result.isConsistent = true;
+    result.hasWallAttachedToEachNonCenterPost = true;
+    for (int x = 0; x < width; x += 1) {
+        for (int y = 0; y < height; y += 1) {
+            int index = height * x + y;
+            unsigned char tile = walls[index];
+
+            // Enclosed
+            if (
+                (x == 0 && !(tile & W)) ||
+                (y == 0 && !(tile & S)) ||
+                (x == width - 1 && !(tile & E)) ||
+                (y == height - 1 && !(tile & N))
+            ) {
+                result.isEnclosed = false;
+            }
+
+            // Consistent, and merge regions that aren't separated by a wall
+            if (x < width - 1) {
+                int east = index + height;
+                if (!(tile & E) != !(walls[east] & W)) {
+                    result.isConsistent = false;
+                }
+                else if (!(tile & E)) {
+                    numRegions -= unite(parents, index, east);
+                }
+            }
+            if (y < height - 1) {
+                int north = index + 1;
+                if (!(tile & N) != !(walls[north] & S)) {
+                    result.isConsistent = false;
+                }
+                else if (!(tile & N)) {
+                    numRegions -= unite(parents, index, north);
+                }
+            }
+
+            // The post at the upper right corner of the tile
+            if (
+                x < width - 1 &&
+                y < height - 1 &&
+                !(tile & (N | E)) &&
+                !(walls[index + height + 1] & (S | W)) &&
+                !(x == centerPost.first && y == centerPost.second)
+            ) {
+                result.hasWallAttachedToEachNonCenterPost = false;
+            }
+        }
+    }
+
+    // The official checks are meaningless for an invalid maze
+    if (!result.isValid()) {
+        result.hasWallAttachedToEachNonCenterPost = false;
+        return result;
+    }
+
+    // If every tile is in the same region, every tile is reachable
+    result.hasNoInaccessibleLocations = numRegions == 1;
+
+    // The starting tile already has west and south walls, since the maze
+    // is enclosed, so it must have exactly one of the north and east walls
+    result.hasThreeStartingWalls = !(walls[0] & N) != !(walls[0] & E);
+
+    // Walls between center tiles make it non-hollow, missing walls between
+    // center tiles and non-center tiles are entrances to the center
+    static const int dx[] = {0, 1, 0, -1};
+    static const int dy[] = {1, 0, -1, 0};
+    int numEntrances = 0;
+    result.hasHollowCenter = true;
+    for (const QPair<int, int>& position : centerPositions) {
+        unsigned char tile = walls[grid.getIndex(position.first, position.second)];
+        for (int d = 0; d < 4; d += 1) {
+            bool isWall = (tile & (1 << d)) != 0;
+            int nx = position.first + dx[d];
+            int ny = position.second + dy[d];
+            if (isCenterPosition(centerPositions, nx, ny)) {
+                if (isWall) {
+                    result.hasHollowCenter = false;
+                }
+            }
+            else if (!isWall) {
+                numEntrances += 1;
+            }
+        }
+    }
+    result.hasOneEntranceToCenter = numEntrances == 1;
+
+    // Neither a left nor a right wall follower should reach the center
+    QVector<unsigned char> visited(width * height, 0);
+    result.isUnsolvableByWallFollower = (
+        !isSolvableByWallFollower(grid, true, &visited) &&
+        !isSolvableByWallFollower(grid, false, &visited)
+    );
+
+    return result;
+}
+
+bool MazeChecker::isValid(const WallGrid& grid) {
+    return check(grid).isValid();
+}
+
+bool MazeChecker::isOfficial(const WallGrid& grid) {
+    return check(grid).isOfficial();
+}
+
+int MazeChecker::find(int* parents, int index) {
+    while (parents[index] != index) {
+        // Path halving keeps the trees shallow
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+int MazeChecker::unite(int* parents, int one, int two) {
+    // Returns the number of regions that were eliminated (zero or one)
+    int rootOne = find(parents, one);
+    int rootTwo = find(parents, two);
+    if (rootOne == rootTwo) {
+        return 0;
+    }
+    parents[rootTwo] = rootOne;
+    return 1;
+}
+
+bool MazeChecker::isSolvableByWallFollower(
+        const WallGrid& grid,
+        bool followRightWall,
+        QVector<unsigned char>* visited) {
+
+    ASSERT_FA(grid.isEmpty());
+    visited->fill(0);
+    unsigned char* seen = visited->data();
+    const unsigned char* walls = grid.data();
+    QVector<QPair<int, int>> centerPositions = grid.getCenterPositions();
+
+    // Directions are indices into DIRECTIONS(), i.e., clockwise from north
+    static const int dx[] = {0, 1, 0, -1};
+    static const int dy[] = {1, 0, -1, 0};
+    int turn = followRightWall ? 1 : 3;
+
+    // The walk is deterministic, so the mouse is stuck in a loop as soon as
+    // it's in the same tile facing the same direction as it was before
+    int x = 0;
+    int y = 0;
+    int d = static_cast<int>(Direction::NORTH);
+    while (true) {
+        if (isCenterPosition(centerPositions, x, y)) {
+            return true;
+        }
+        int index = grid.getIndex(x, y);
+        if (seen[index] & (1 << d)) {
+            return false;
+        }
+        seen[index] |= (1 << d);
+
+        // Prefer the followed wall's side, then straight, then the other
+        // side, then turning around
+        int next = (d + turn) % 4;
+        int attempts = 0;
+        while (walls[index] & (1 << next)) {
+            next = (next + 4 - turn) % 4;
+            attempts += 1;
+            if (attempts == 4) {
+                return false;
+            }
+        }
+        d = next;
+        x += dx[d];
+        y += dy[d];
+    }
+}
+
+bool MazeChecker::isCenterPosition(
+        const QVector<QPair<int, int>>& centerPositions,
+        int x,
+        int y) {
+    for (const QPair<int, int>& position : centerPositions) {
+        if (position.first == x && position.second == y) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QStringList>
+#include <QVector>
+
+#include "WallGrid.h"
+
+namespace mms {
+
+// The outcome of every check performed by the MazeChecker
+struct MazeCheck {
+
+    // Criteria for a maze that is usable by the simulator
+    bool isNonempty;
+    bool isEnclosed;
+    bool isConsistent;
+
+    // Criteria for a maze that complies with the official rules
+    bool hasNoInaccessibleLocations;
+    bool hasThreeStartingWalls;
+    bool hasOneEntranceToCenter;
+    bool hasHollowCenter;
+    bool hasWallAttachedToEachNonCenterPost;
+    bool isUnsolvableByWallFollower;
+
+    bool isValid() const;
+    bool isOfficial() const;
+
+    // The official requirements that the maze doesn't meet, described as in
+    // the README, or nothing if the maze isn't even valid
+    QStringList getFailedOfficialChecks() const;
+};
+
+class MazeChecker {
+
+public:
+
+    // The MazeChecker class is not constructible
+    MazeChecker() = delete;
+
+    // Performs all of the checks in a single pass over the wall grid. The
+    // official checks are only performed (and can only be true) if the maze
+    // is valid. This requires no graphics or file I/O, and is therefore cheap
+    // enough to run over entire libraries of mazes.
+    static MazeCheck check(const WallGrid& grid);
+
+    // Convenience wrappers around check()
+    static bool isValid(const WallGrid& grid);
+    static bool isOfficial(const WallGrid& grid);
+
+private:
+
+    // Union-find helpers, used to count connected regions of the maze
+    static int find(int* parents, int index);
+    static int unite(int* parents, int one, int two);
+
+    // Walks the maze from the starting tile, keeping one hand on the wall,
+    // and returns whether or not a center tile is ever reached
+    static bool isSolvableByWallFollower(
+        const WallGrid& grid,
+        bool followRightWall,
+        QVector<unsigned char>* visited);
+
+    static bool isCenterPosition(
+        const QVector<QPair<int, int>>& centerPositions,
+        int x,
+        int y);
+};
+
+}
@@ -0,0 +1,474 @@
+#include "MazeGenerator.h"
+
+#include <QThread>
+#include <QtMath>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AssertMacros.h"
+#include "MazeChecker.h"
+
+namespace mms {
+
+const double MazeGenerator::RANDOMIZE_WALL_PROBABILITY = 0.40;
+
+// Number between 0-1 which determines how straight the maze becomes closer to
+// the edges. Number between 0-1 which determines if the algorithm will break
+// down a wall at a dead end. The minimum gradient across a dead end wall
+// required to break it down. Number of walls to break in the finished maze.
+const double MazeGenerator::TOMASZ_STRAIGHT_FACTOR = 0.85;
+const double MazeGenerator::TOMASZ_DEAD_END_BREAK_CHANCE = 0.75;
+const int MazeGenerator::TOMASZ_DEAD_END_BREAK_THRESHOLD = 8;
+const int MazeGenerator::TOMASZ_GRADIENT_WALL_BREAKS = 3;
+
+// Special values for the tile depths used by the Tomasz generator
+static const int UNEXPLORED = -1;
+static const int CENTER = -2;
+
+// Directions are indices into DIRECTIONS(), i.e., clockwise from north
+static const int DX[] = {0, 1, 0, -1};
+static const int DY[] = {1, 0, -1, 0};
+
+WallGrid MazeGenerator::generate(
+        MazeGeneratorType type,
+        int width,
+        int height,
+        quint64 seed) {
+
+    ASSERT_LT(0, width);
+    ASSERT_LT(0, height);
+
+    WallGrid grid(width, height);
+    quint64 state = seed;
+    switch (type) {
+        case MazeGeneratorType::RANDOMIZE:
+            generateRandomize(&grid, &state);
+            break;
+        case MazeGeneratorType::TOMASZ:
+            generateTomasz(&grid, &state);
+            break;
+    }
+    return grid;
+}
+
+WallGrid MazeGenerator::generateOfficial(
+        MazeGeneratorType type,
+        int width,
+        int height,
+        quint64 seed,
+        int maxAttempts) {
+    for (int attempt = 0; attempt < maxAttempts; attempt += 1) {
+        WallGrid grid = generate(
+            type,
+            width,
+            height,
+            attempt == 0 ? seed : deriveSeed(seed, attempt)
+        );
+        if (MazeChecker::isOfficial(grid)) {
+            return grid;
+        }
+    }
+    return WallGrid();
+}
+
+QVector<WallGrid> MazeGenerator::generateBatch(
+        MazeGeneratorType type,
+        int width,
+        int height,
+        quint64 seed,
+        int count,
+        bool officialOnly) {
+
+    // Each worker claims the next unclaimed index and writes the result
+    // directly into its slot, so no synchronization is needed on the output
+    QVector<WallGrid> grids(count);
+    WallGrid* output = grids.data();
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        while (true) {
+            int index = next.fetch_add(1);
+            if (count <= index) {
+                return;
+            }
+            quint64 elementSeed = deriveSeed(seed, index);
+            output[index] = officialOnly
+                ? generateOfficial(type, width, height, elementSeed)
+                : generate(type, width, height, elementSeed);
+        }
+    };
+
+    int numThreads = qBound(1, QThread::idealThreadCount(), qMax(1, count));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads - 1; i += 1) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return grids;
+}
+
+quint64 MazeGenerator::deriveSeed(quint64 seed, quint64 index) {
+    quint64 state = seed ^ (index * 0xD1B54A32D192ED03ULL);
+    return nextRandom(&state);
+}
+
+quint64 MazeGenerator::nextRandom(quint64* state) {
+    quint64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double MazeGenerator::nextDouble(quint64* state) {
+    // Uniform in [0, 1), using the top 53 bits
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int MazeGenerator::nextInt(quint64* state, int bound) {
+    // Uniform in [0, bound), without a modulo
+    return static_cast<int>(((nextRandom(state) >> 32) * bound) >> 32);
+}
+
+void MazeGenerator::generateRandomize(WallGrid* grid, quint64* state) {
+
+    int width = grid->getWidth();
+    int height = grid->getHeight();
+
+    // Each interior wall exists with some probability, and we only decide the
+    // north and east walls of each tile so that every wall is decided once
+    for (int x = 0; x < width; x += 1) {
+        for (int y = 0; y < height; y += 1) {
+            if (x == 0) {
+                setWall(grid, x, y, 3, true);
+            }
+            if (y == 0) {
+                setWall(grid, x, y, 2, true);
+            }
+            bool isNorthWall = (
+                y == height - 1 ||
+                nextDouble(state) <= RANDOMIZE_WALL_PROBABILITY
+            );
+            bool isEastWall = (
+                x == width - 1 ||
+                nextDouble(state) <= RANDOMIZE_WALL_PROBABILITY
+            );
+            setWall(grid, x, y, 0, isNorthWall);
+            setWall(grid, x, y, 1, isEastWall);
+        }
+    }
+}
+
+void MazeGenerator::generateTomasz(WallGrid* grid, quint64* state) {
+
+    int width = grid->getWidth();
+    int height = grid->getHeight();
+
+    // Initialize a maze with walls in every location
+    for (int x = 0; x < width; x += 1) {
+        for (int y = 0; y < height; y += 1) {
+            grid->setWalls(x, y, 0xF);
+        }
+    }
+
+    // The depth of each tile in the depth first search tree. The center is
+    // marked so that the search never goes into it, and is hollowed out up
+    // front so that we don't have to do it later.
+    QVector<int> depthVector(width * height, UNEXPLORED);
+    int* depths = depthVector.data();
+    QVector<QPair<int, int>> centerPositions = grid->getCenterPositions();
+    for (const QPair<int, int>& position : centerPositions) {
+        depths[grid->getIndex(position.first, position.second)] = CENTER;
+    }
+    for (const QPair<int, int>& position : centerPositions) {
+        for (int direction = 0; direction < 4; direction += 1) {
+            int nx = position.first + DX[direction];
+            int ny = position.second + DY[direction];
+            if (
+                isWithinGrid(*grid, nx, ny) &&
+                depths[grid->getIndex(nx, ny)] == CENTER
+            ) {
+                setWall(grid, position.first, position.second, direction, false);
+            }
+        }
+    }
+
+    // The starting tile should have exactly three walls, so the search leaves
+    // it heading north and never comes back to it
+    QVector<int> stack;
+    stack.reserve(width * height);
+    depths[0] = 0;
+    if (1 < height && depths[1] == UNEXPLORED) {
+        setWall(grid, 0, 0, 0, false);
+        depths[1] = 1;
+        stack.append(1);
+    }
+    else {
+        stack.append(0);
+    }
+
+    // Continue the depth first search until we've explored every tile
+    int lastDirection = -1;
+    while (!stack.isEmpty()) {
+
+        int index = stack.last();
+        int x = index / height;
+        int y = index % height;
+
+        // Keep track of the next possible movements
+        int choices = 0;
+        int numChoices = 0;
+        for (int direction = 0; direction < 4; direction += 1) {
+            int nx = x + DX[direction];
+            int ny = y + DY[direction];
+            if (
+                0 <= nx && nx < width &&
+                0 <= ny && ny < height &&
+                depths[height * nx + ny] == UNEXPLORED
+            ) {
+                choices |= (1 << direction);
+                numChoices += 1;
+            }
+        }
+
+        // If the current tile has no more paths forward, backtrack. If we just
+        // reached the end of a path, maybe break the wall towards the greatest
+        // gradient, which results in more open mazes.
+        if (numChoices == 0) {
+            stack.removeLast();
+            if (
+                lastDirection != -1 &&
+                nextDouble(state) <= TOMASZ_DEAD_END_BREAK_CHANCE
+            ) {
+                breakGradientWall(grid, depths, x, y);
+            }
+            lastDirection = -1;
+            continue;
+        }
+
+        // The chance that we continue in the same direction is proportional
+        // to the distance from the center
+        double xCenterDistance =
+            qAbs(x - width / 2.0) * 2.0 / qMax(width - 1, 1);
+        double yCenterDistance =
+            qAbs(y - height / 2.0) * 2.0 / qMax(height - 1, 1);
+        double moveConst =
+            TOMASZ_STRAIGHT_FACTOR * qMax(xCenterDistance, yCenterDistance);
+
+        // Either go straight, or choose randomly amongst the other options
+        bool canGoStraight = (
+            lastDirection != -1 &&
+            (choices & (1 << lastDirection)) &&
+            numChoices != 1
+        );
+        int direction = lastDirection;
+        if (!canGoStraight || moveConst < nextDouble(state)) {
+            if (canGoStraight) {
+                choices &= ~(1 << lastDirection);
+                numChoices -= 1;
+            }
+            int choice = nextInt(state, numChoices);
+            for (direction = 0; direction < 4; direction += 1) {
+                if (choices & (1 << direction)) {
+                    if (choice == 0) {
+                        break;
+                    }
+                    choice -= 1;
+                }
+            }
+        }
+
+        // Break down the wall and push the next tile onto the stack
+        int next = height * (x + DX[direction]) + y + DY[direction];
+        setWall(grid, x, y, direction, false);
+        depths[next] = depths[index] + 1;
+        stack.append(next);
+        lastDirection = direction;
+    }
+
+    // Create some loops, then make exactly one entrance to the center
+    breakGradientWalls(grid, depths);
+    pathIntoCenter(grid, depths);
+}
+
+bool MazeGenerator::isBreakable(
+        const WallGrid& grid,
+        const int* depths,
+        int x,
+        int y,
+        int direction) {
+    // Both tiles must be explored, not in the center, and not the starting
+    // tile, and there must actually be a wall between them
+    int height = grid.getHeight();
+    int nx = x + DX[direction];
+    int ny = y + DY[direction];
+    if (nx < 0 || grid.getWidth() <= nx || ny < 0 || height <= ny) {
+        return false;
+    }
+    int index = height * x + y;
+    int neighbor = height * nx + ny;
+    if (
+        index == 0 ||
+        neighbor == 0 ||
+        depths[index] < 0 ||
+        depths[neighbor] < 0 ||
+        !(grid.data()[index] & (1 << direction))
+    ) {
+        return false;
+    }
+
+    // Official mazes have a wall attached to every post, so the posts at
+    // either end of the wall must have at least one other wall attached
+    static const int POST_DX[][2] = {{0, 1}, {1, 1}, {0, 1}, {0, 0}};
+    static const int POST_DY[][2] = {{1, 1}, {0, 1}, {0, 0}, {0, 1}};
+    for (int end = 0; end < 2; end += 1) {
+        int px = x + POST_DX[direction][end];
+        int py = y + POST_DY[direction][end];
+        if (countPostWalls(grid, px, py) < 2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MazeGenerator::breakGradientWall(
+        WallGrid* grid,
+        const int* depths,
+        int x,
+        int y) {
+    int current = depths[grid->getIndex(x, y)];
+    int biggestDifference = 0;
+    int directionToBreak = -1;
+    for (int direction = 0; direction < 4; direction += 1) {
+        if (!isBreakable(*grid, depths, x, y, direction)) {
+            continue;
+        }
+        int neighbor = grid->getIndex(x + DX[direction], y + DY[direction]);
+        int difference = qAbs(depths[neighbor] - current);
+        if (biggestDifference < difference) {
+            biggestDifference = difference;
+            directionToBreak = direction;
+        }
+    }
+    if (biggestDifference <= TOMASZ_DEAD_END_BREAK_THRESHOLD) {
+        return false;
+    }
+    setWall(grid, x, y, directionToBreak, false);
+    return true;
+}
+
+void MazeGenerator::breakGradientWalls(WallGrid* grid, const int* depths) {
+    // Break the walls with the biggest gradient across them; only the north
+    // and east walls are considered so that each wall is looked at once
+    int width = grid->getWidth();
+    int height = grid->getHeight();
+    for (int i = 0; i < TOMASZ_GRADIENT_WALL_BREAKS; i += 1) {
+        int biggestDifference = 0;
+        int xOfBiggest = 0;
+        int yOfBiggest = 0;
+        for (int x = 0; x < width; x += 1) {
+            for (int y = 0; y < height; y += 1) {
+                int current = depths[height * x + y];
+                for (int direction : {0, 1}) {
+                    if (!isBreakable(*grid, depths, x, y, direction)) {
+                        continue;
+                    }
+                    int neighbor = height * (x + DX[direction]) + y + DY[direction];
+                    int difference = qAbs(depths[neighbor] - current);
+                    if (biggestDifference < difference) {
+                        biggestDifference = difference;
+                        xOfBiggest = x;
+                        yOfBiggest = y;
+                    }
+                }
+            }
+        }
+        if (!breakGradientWall(grid, depths, xOfBiggest, yOfBiggest)) {
+            return;
+        }
+    }
+}
+
+void MazeGenerator::pathIntoCenter(WallGrid* grid, const int* depths) {
+    // Find the deepest tile touching the center, and break that wall
+    int greatestDepth = -1;
+    QPair<int, int> positionOfGreatest = {-1, -1};
+    int directionOfGreatest = -1;
+    for (const QPair<int, int>& position : grid->getCenterPositions()) {
+        for (int direction = 0; direction < 4; direction += 1) {
+            int nx = position.first + DX[direction];
+            int ny = position.second + DY[direction];
+            if (!isWithinGrid(*grid, nx, ny)) {
+                continue;
+            }
+            int depth = depths[grid->getIndex(nx, ny)];
+            if (greatestDepth < depth) {
+                greatestDepth = depth;
+                positionOfGreatest = position;
+                directionOfGreatest = direction;
+            }
+        }
+    }
+    if (directionOfGreatest != -1) {
+        setWall(
+            grid,
+            positionOfGreatest.first,
+            positionOfGreatest.second,
+            directionOfGreatest,
+            false
+        );
+    }
+}
+
+int MazeGenerator::countPostWalls(const WallGrid& grid, int px, int py) {
+    int height = grid.getHeight();
+    if (px <= 0 || grid.getWidth() <= px || py <= 0 || height <= py) {
+        return 4;
+    }
+    // The walls above, below, left of, and right of the post
+    const unsigned char* walls = grid.data();
+    int upperLeft = height * (px - 1) + py;
+    int lowerLeft = upperLeft - 1;
+    return (
+        ((walls[upperLeft] >> 1) & 1) +
+        ((walls[lowerLeft] >> 1) & 1) +
+        (walls[lowerLeft] & 1) +
+        (walls[lowerLeft + height] & 1)
+    );
+}
+
+void MazeGenerator::setWall(
+        WallGrid* grid,
+        int x,
+        int y,
+        int direction,
+        bool isWall) {
+    // Works directly on the flat representation, since this is called for
+    // nearly every wall of every generated maze
+    int height = grid->getHeight();
+    unsigned char* walls = grid->data();
+    int index = height * x + y;
+    unsigned char bit = 1 << direction;
+    walls[index] = isWall ? (walls[index] | bit) : (walls[index] & ~bit);
+    int nx = x + DX[direction];
+    int ny = y + DY[direction];
+    if (isWithinGrid(*grid, nx, ny)) {
+        int neighbor = height * nx + ny;
+        unsigned char opposite = 1 << ((direction + 2) % 4);
+        walls[neighbor] = isWall
+            ? (walls[neighbor] | opposite)
+            : (walls[neighbor] & ~opposite);
+    }
+}
+
+bool MazeGenerator::isWithinGrid(const WallGrid& grid, int x, int y) {
+    return (
+        0 <= x && x < grid.getWidth() &&
+        0 <= y && y < grid.getHeight()
+    );
+}
+
+}
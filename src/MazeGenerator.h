@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QVector>
+
+#include "WallGrid.h"
+
+namespace mms {
+
+enum class MazeGeneratorType {
+    // Randomly decides whether or not each wall should exist. Terrible at
+    // generating good mazes, but a good example of a simple generator.
+    RANDOMIZE,
+    // Tomasz Pietruszka's generator: a depth first search that prefers going
+    // straight near the edges of the maze, and that breaks walls at dead ends
+    // to create loops. Produces realistic, often official, mazes.
+    TOMASZ,
+};
+
+class MazeGenerator {
+
+public:
+
+    // The MazeGenerator class is not constructible
+    MazeGenerator() = delete;
+
+    // Generates a single maze directly into the compact representation. The
+    // same type, size, and seed always produce the same maze.
+    static WallGrid generate(
+        MazeGeneratorType type,
+        int width,
+        int height,
+        quint64 seed);
+
+    // Like generate(), but keeps trying derived seeds until the maze complies
+    // with the official rules. Gives up (returning an empty grid) after
+    // maxAttempts, since some types and sizes can never be official.
+    static WallGrid generateOfficial(
+        MazeGeneratorType type,
+        int width,
+        int height,
+        quint64 seed,
+        int maxAttempts = 1000);
+
+    // Generates count mazes on all available cores. The maze at index i only
+    // depends on the seed and i, not on how the work was scheduled, so that
+    // batches are reproducible and can be regenerated instead of stored.
+    static QVector<WallGrid> generateBatch(
+        MazeGeneratorType type,
+        int width,
+        int height,
+        quint64 seed,
+        int count,
+        bool officialOnly);
+
+    // Derives a well-mixed seed for a particular element of a batch
+    static quint64 deriveSeed(quint64 seed, quint64 index);
+
+private:
+
+    // A small, fast, seedable generator (splitmix64). We don't use
+    // qrand() since it's neither reproducible across platforms nor
+    // safe to use from multiple threads at once.
+    static quint64 nextRandom(quint64* state);
+    static double nextDouble(quint64* state);
+    static int nextInt(quint64* state, int bound);
+
+    // Randomize parameters
+    static const double RANDOMIZE_WALL_PROBABILITY;
+
+    // Tomasz parameters
+    static const double TOMASZ_STRAIGHT_FACTOR;
+    static const double TOMASZ_DEAD_END_BREAK_CHANCE;
+    static const int TOMASZ_DEAD_END_BREAK_THRESHOLD;
+    static const int TOMASZ_GRADIENT_WALL_BREAKS;
+
+    static void generateRandomize(WallGrid* grid, quint64* state);
+    static void generateTomasz(WallGrid* grid, quint64* state);
+
+    // Tomasz helpers. Rather than re-running a breadth first search after
+    // every broken wall, like the original did, the "gradient" across a wall
+    // is the difference in depth of its tiles in the depth first search tree.
+    // That keeps generation linear in the number of tiles.
+    static bool isBreakable(const WallGrid& grid, const int* depths, int x, int y, int direction);
+    static bool breakGradientWall(WallGrid* grid, const int* depths, int x, int y);
+    static void breakGradientWalls(WallGrid* grid, const int* depths);
+    static void pathIntoCenter(WallGrid* grid, const int* depths);
+
+    // Returns the number of walls attached to the post at (px, py), where
+    // (0, 0) is the lower left post of the maze. Posts on the perimeter are
+    // always attached to the perimeter, so they report all four walls.
+    static int countPostWalls(const WallGrid& grid, int px, int py);
+
+    // Sets both sides of a wall, if the neighboring tile exists
+    static void setWall(WallGrid* grid, int x, int y, int direction, bool isWall);
+    static bool isWithinGrid(const WallGrid& grid, int x, int y);
+
+};
+
+}
@@ -6,13 +6,14 @@ namespace mms {
 
 MazeGraphic::MazeGraphic(
         const Maze* maze,
-        BufferInterface* bufferInterface) {
+        BufferInterface* bufferInterface) :
+        m_height(maze->getHeight()),
+        m_isDirty(maze->getWidth() * maze->getHeight(), false) {
     for (int x = 0; x < maze->getWidth(); x += 1) {
         QVector<TileGraphic> column;
+        column.reserve(maze->getHeight());
         for (int y = 0; y < maze->getHeight(); y += 1) {
-            column.append(TileGraphic(
-                maze->getTile(x, y),
-                bufferInterface));
+            column.append(TileGraphic(maze, x, y, bufferInterface));
         }
         m_tileGraphics.append(column);
     }
@@ -20,26 +21,41 @@ MazeGraphic::MazeGraphic(
 
 void MazeGraphic::setWall(int x, int y, Direction direction) {
     m_tileGraphics[x][y].setWall(direction);
+    markDirty(x, y);
 }
 
 void MazeGraphic::clearWall(int x, int y, Direction direction) {
     m_tileGraphics[x][y].clearWall(direction);
+    markDirty(x, y);
 }
 
 void MazeGraphic::setColor(int x, int y, Color color) {
     m_tileGraphics[x][y].setColor(color);
+    markDirty(x, y);
 }
 
 void MazeGraphic::clearColor(int x, int y) {
     m_tileGraphics[x][y].clearColor();
+    markDirty(x, y);
 }
 
 void MazeGraphic::setText(int x, int y, const QString& text) {
     m_tileGraphics[x][y].setText(text);
+    markDirty(x, y);
 }
 
 void MazeGraphic::clearText(int x, int y) {
     m_tileGraphics[x][y].clearText();
+    markDirty(x, y);
+}
+
+void MazeGraphic::flush() {
+    for (const QPair<int, int>& tile : m_dirtyTiles) {
+        m_tileGraphics[tile.first][tile.second].flush();
+        m_isDirty[m_height * tile.first + tile.second] = false;
+    }
+    // Note that clear() keeps the capacity of the vector
+    m_dirtyTiles.clear();
 }
 
 void MazeGraphic::drawPolygons() const {
@@ -51,6 +67,14 @@ void MazeGraphic::drawPolygons() const {
     }
 }
 
+void MazeGraphic::markDirty(int x, int y) {
+    int index = m_height * x + y;
+    if (!m_isDirty.at(index)) {
+        m_isDirty[index] = true;
+        m_dirtyTiles.append({x, y});
+    }
+}
+
 void MazeGraphic::drawTextures() {
     // Fill the TEXTURE_CPU_BUFFER
     for (int x = 0; x < m_tileGraphics.size(); x += 1) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QPair>
 #include <QVector>
 
 #include "BufferInterface.h"
@@ -26,6 +27,12 @@ public:
     void setText(int x, int y, const QString& text);
     void clearText(int x, int y);
 
+    // The setters above only record the new state of the tile, so that an
+    // algorithm can change a tile any number of times between frames without
+    // touching the buffers; this applies the latest state of each changed
+    // tile to the buffers, and should be called once before each frame
+    void flush();
+
     // TODO: upforgrabs
     // Why is only one of these const?
     void drawPolygons() const;
@@ -35,6 +42,12 @@ private:
 
     QVector<QVector<TileGraphic>> m_tileGraphics;
 
+    // The tiles that have changed since the last flush, each listed once
+    int m_height;
+    QVector<bool> m_isDirty;
+    QVector<QPair<int, int>> m_dirtyTiles;
+    void markDirty(int x, int y);
+
 };
 
 } 
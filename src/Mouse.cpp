@@ -78,6 +78,14 @@ void Mouse::teleport(const Coordinate& translation, const Angle& rotation) {
     m_currentRotation = rotation;
 }
 
+Coordinate Mouse::getCurrentTranslation() const {
+    return m_currentTranslation;
+}
+
+Angle Mouse::getCurrentRotation() const {
+    return m_currentRotation;
+}
+
 QPair<int, int> Mouse::getCurrentDiscretizedTranslation() const {
     static Distance tileLength = Dimensions::tileLength();
     int x = static_cast<int>(qFloor(m_currentTranslation.getX() / tileLength));
@@ -104,20 +112,36 @@ Direction Mouse::getCurrentDiscretizedRotation() const {
     }
 }
 
-Polygon Mouse::getCurrentBodyPolygon() const {
-    return getCurrentPolygon(m_initialBodyPolygon);
+void Mouse::getCurrentBodyPolygon(Polygon* output) const {
+    getCurrentPolygon(m_initialBodyPolygon, output);
+}
+
+void Mouse::getCurrentWheelPolygon(Polygon* output) const {
+    getCurrentPolygon(m_initialWheelPolygon, output);
+}
+
+Coordinate Mouse::getInitialTranslation() const {
+    return m_initialTranslation;
+}
+
+Angle Mouse::getInitialRotation() const {
+    return m_initialRotation;
 }
 
-Polygon Mouse::getCurrentWheelPolygon() const {
-    return getCurrentPolygon(m_initialWheelPolygon);
+const Polygon& Mouse::getInitialBodyPolygon() const {
+    return m_initialBodyPolygon;
 }
 
-Polygon Mouse::getCurrentPolygon(const Polygon& initialPolygon) const {
-    return initialPolygon
-        .translate(m_currentTranslation - m_initialTranslation)
-        .rotateAroundPoint(
-            m_currentRotation - m_initialRotation,
-            m_currentTranslation);
+void Mouse::getCurrentPolygon(
+        const Polygon& initialPolygon,
+        Polygon* output) const {
+    initialPolygon.translate(
+        m_currentTranslation - m_initialTranslation,
+        output);
+    output->rotateAroundPoint(
+        m_currentRotation - m_initialRotation,
+        m_currentTranslation,
+        output);
 }
 
 } 
@@ -26,13 +26,24 @@ public:
     // Sets the current translation and rotation of the mouse
     void teleport(const Coordinate& translation, const Angle& rotation);
 
+    // Gets the current translation and rotation of the mouse
+    Coordinate getCurrentTranslation() const;
+    Angle getCurrentRotation() const;
+
     // Gets the current discretized translation and rotation of the mouse
     QPair<int, int> getCurrentDiscretizedTranslation() const;
     Direction getCurrentDiscretizedRotation() const;
 
-    // Retrieves the polygon of just the body of the mouse
-    Polygon getCurrentBodyPolygon() const;
-    Polygon getCurrentWheelPolygon() const;
+    // Retrieves the polygon of just the body of the mouse, writing it into
+    // the output so that callers can reuse one polygon from frame to frame
+    void getCurrentBodyPolygon(Polygon* output) const;
+    void getCurrentWheelPolygon(Polygon* output) const;
+
+    // The pose at the beginning of the maze, and the body in that pose, which
+    // the continuous simulation uses as the shape of the mouse
+    Coordinate getInitialTranslation() const;
+    Angle getInitialRotation() const;
+    const Polygon& getInitialBodyPolygon() const;
 
 private:
 
@@ -45,7 +56,7 @@ private:
     // The parts of the mouse at the starting location
     Polygon m_initialBodyPolygon;
     Polygon m_initialWheelPolygon;
-    Polygon getCurrentPolygon(const Polygon& initialPolygon) const;
+    void getCurrentPolygon(const Polygon& initialPolygon, Polygon* output) const;
 };
 
 } 
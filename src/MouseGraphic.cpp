@@ -6,22 +6,31 @@
 namespace mms {
 
 MouseGraphic::MouseGraphic(const Mouse* mouse) :
-    m_mouse(mouse) {
+    MouseGraphic(mouse, ColorManager::getMouseBodyColor()) {
 }
 
-QVector<TriangleGraphic> MouseGraphic::draw() const {
-    QVector<TriangleGraphic> buffer;
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentWheelPolygon(),
+MouseGraphic::MouseGraphic(const Mouse* mouse, Color bodyColor) :
+    m_mouse(mouse),
+    m_bodyColor(bodyColor) {
+}
+
+void MouseGraphic::draw(QVector<TriangleGraphic>* buffer) const {
+    // The polygons are small enough to live entirely on the stack
+    Polygon polygon;
+    m_mouse->getCurrentWheelPolygon(&polygon);
+    SimUtilities::polygonToTriangleGraphics(
+        polygon,
         ColorManager::getMouseWheelColor(),
-        255
-    ));
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentBodyPolygon(),
-        ColorManager::getMouseBodyColor(),
-        255
-    ));
-    return buffer;
+        255,
+        buffer
+    );
+    m_mouse->getCurrentBodyPolygon(&polygon);
+    SimUtilities::polygonToTriangleGraphics(
+        polygon,
+        m_bodyColor,
+        255,
+        buffer
+    );
 }
 
 } 
@@ -2,6 +2,7 @@
 
 #include <QVector>
 
+#include "Color.h"
 #include "Mouse.h"
 #include "TriangleGraphic.h"
 
@@ -11,10 +12,16 @@ class MouseGraphic {
 
 public:
     MouseGraphic(const Mouse* mouse);
-    QVector<TriangleGraphic> draw() const;
+
+    // Mice with different body colors can be told apart when they share a maze
+    MouseGraphic(const Mouse* mouse, Color bodyColor);
+
+    // Appends the triangles of the mouse to the buffer
+    void draw(QVector<TriangleGraphic>* buffer) const;
 
 private:
     const Mouse* m_mouse;
+    Color m_bodyColor;
 
 };
 
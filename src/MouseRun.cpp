@@ -0,0 +1,311 @@
+#include "MouseRun.h"
+
+#include "units/Angle.h"
+#include "units/Coordinate.h"
+
+namespace mms {
+
+MouseRun::MouseRun(const Maze* maze, const QString& name, Color bodyColor) :
+    m_name(name),
+    m_process(nullptr),
+    m_mouse(new Mouse()),
+    m_view(new MazeView(maze)),
+    m_mouseGraphic(new MouseGraphic(m_mouse, bodyColor)),
+    m_maze(maze),
+    m_world(nullptr),
+    m_hasCrashed(false),
+    m_wasReset(false),
+    m_isRecorded(false),
+    m_hasFailed(false),
+    m_commandBufferStart(0),
+    m_outputArrivalTime(0),
+    m_commandQueueTimer(new QTimer()),
+    m_startingLocation({0, 0}),
+    m_startingDirection(Direction::NORTH),
+    m_movement(Movement::NONE),
+    m_movementProgress(0.0),
+    m_movementStepSize(0.0),
+    m_movementStartTime(0) {
+    m_commandQueueTimer->setSingleShot(true);
+}
+
+MouseRun::~MouseRun() {
+    // The world's thread reads the maze, so it's stopped first
+    delete m_world;
+    delete m_commandQueueTimer;
+    delete m_process;
+    delete m_mouseGraphic;
+    delete m_view;
+    delete m_mouse;
+}
+
+QString MouseRun::getName() const {
+    return m_name;
+}
+
+Mouse* MouseRun::getMouse() const {
+    return m_mouse;
+}
+
+MazeView* MouseRun::getView() const {
+    return m_view;
+}
+
+MouseGraphic* MouseRun::getMouseGraphic() const {
+    return m_mouseGraphic;
+}
+
+QProcess* MouseRun::getProcess() const {
+    return m_process;
+}
+
+void MouseRun::setProcess(QProcess* process) {
+    m_process = process;
+}
+
+void MouseRun::deleteProcess() {
+    delete m_process;
+    m_process = nullptr;
+}
+
+World* MouseRun::getWorld() const {
+    return m_world;
+}
+
+World* MouseRun::startWorld() {
+    if (m_world == nullptr) {
+        m_world = new World(m_maze, m_mouse);
+    }
+    return m_world;
+}
+
+void MouseRun::stopWorld() {
+    if (m_world == nullptr) {
+        return;
+    }
+    Coordinate translation;
+    Angle rotation;
+    m_world->getPose(&translation, &rotation);
+    m_mouse->teleport(translation, rotation);
+    delete m_world;
+    m_world = nullptr;
+}
+
+bool MouseRun::hasCrashed() const {
+    return m_hasCrashed;
+}
+
+void MouseRun::setHasCrashed(bool hasCrashed) {
+    m_hasCrashed = hasCrashed;
+}
+
+bool MouseRun::wasReset() const {
+    return m_wasReset;
+}
+
+void MouseRun::setWasReset(bool wasReset) {
+    m_wasReset = wasReset;
+}
+
+bool MouseRun::isRecorded() const {
+    return m_isRecorded;
+}
+
+void MouseRun::setIsRecorded(bool isRecorded) {
+    m_isRecorded = isRecorded;
+}
+
+bool MouseRun::hasFailed() const {
+    return m_hasFailed;
+}
+
+void MouseRun::setHasFailed(bool hasFailed) {
+    m_hasFailed = hasFailed;
+}
+
+QStringList* MouseRun::getLogBuffer() {
+    return &m_logBuffer;
+}
+
+void MouseRun::appendOutput(const QByteArray& output, qint64 time) {
+    // The commands are parsed straight out of the buffer, which only copies
+    // the output if part of it is still waiting to be dispatched
+    if (m_commandBufferStart == m_commandBuffer.size()) {
+        m_commandBuffer = output;
+        m_commandBufferStart = 0;
+    }
+    else {
+        m_commandBuffer.append(output);
+    }
+    m_outputArrivalTime = time;
+}
+
+qint64 MouseRun::getOutputArrivalTime() const {
+    return m_outputArrivalTime;
+}
+
+bool MouseRun::hasPendingCommands() const {
+    return m_commandBuffer.indexOf('\n', m_commandBufferStart) != -1;
+}
+
+bool MouseRun::takeCommandLine(const char** line, int* length) {
+    int start = m_commandBufferStart;
+    int end = m_commandBuffer.indexOf('\n', start);
+    if (end == -1) {
+        return false;
+    }
+    const char* data = m_commandBuffer.constData();
+    *line = data + start;
+    *length = end - start;
+    if (0 < *length && data[end - 1] == '\r') {
+        *length -= 1;  // Windows compatibility
+    }
+    m_commandBufferStart = end + 1;
+    return true;
+}
+
+void MouseRun::compactOutput() {
+    if (m_commandBufferStart == m_commandBuffer.size()) {
+        m_commandBuffer.clear();
+        m_commandBufferStart = 0;
+    }
+    else if (m_commandBuffer.size() / 2 < m_commandBufferStart) {
+        m_commandBuffer.remove(0, m_commandBufferStart);
+        m_commandBufferStart = 0;
+    }
+}
+
+void MouseRun::clearOutput() {
+    m_commandBuffer.clear();
+    m_commandBufferStart = 0;
+}
+
+void MouseRun::enqueueCommand(const Command& command, qint64 time) {
+    m_commandQueue.enqueue(command);
+    m_commandQueueTimes.enqueue(time);
+}
+
+bool MouseRun::hasQueuedCommands() const {
+    return !m_commandQueue.isEmpty();
+}
+
+const Command& MouseRun::getQueuedCommand() const {
+    return m_commandQueue.head();
+}
+
+qint64 MouseRun::getQueuedCommandTime() const {
+    return m_commandQueueTimes.head();
+}
+
+void MouseRun::dequeueCommand() {
+    m_commandQueue.dequeue();
+    m_commandQueueTimes.dequeue();
+}
+
+void MouseRun::clearCommandQueue() {
+    m_commandQueueTimer->stop();
+    m_commandQueue.clear();
+    m_commandQueueTimes.clear();
+}
+
+QTimer* MouseRun::getCommandQueueTimer() const {
+    return m_commandQueueTimer;
+}
+
+Movement MouseRun::getMovement() const {
+    return m_movement;
+}
+
+void MouseRun::setMovement(Movement movement) {
+    m_movement = movement;
+}
+
+QPair<int, int> MouseRun::getStartingLocation() const {
+    return m_startingLocation;
+}
+
+Direction MouseRun::getStartingDirection() const {
+    return m_startingDirection;
+}
+
+double MouseRun::getMovementProgress() const {
+    return m_movementProgress;
+}
+
+void MouseRun::addMovementProgress(double progress) {
+    m_movementProgress += progress;
+}
+
+double MouseRun::getMovementStepSize() const {
+    return m_movementStepSize;
+}
+
+void MouseRun::setMovementStepSize(double movementStepSize) {
+    m_movementStepSize = movementStepSize;
+}
+
+qint64 MouseRun::getMovementStartTime() const {
+    return m_movementStartTime;
+}
+
+void MouseRun::setMovementStartTime(qint64 time) {
+    m_movementStartTime = time;
+}
+
+void MouseRun::finishMovement() {
+    m_startingLocation = m_mouse->getCurrentDiscretizedTranslation();
+    m_startingDirection = m_mouse->getCurrentDiscretizedRotation();
+    m_movement = Movement::NONE;
+    m_movementProgress = 0.0;
+    m_movementStepSize = 0.0;
+}
+
+void MouseRun::reset() {
+    m_mouse->reset();
+    if (m_world != nullptr) {
+        m_world->reset();
+        m_hasCrashed = false;
+    }
+    m_startingLocation = {0, 0};
+    m_startingDirection = Direction::NORTH;
+    m_movement = Movement::NONE;
+    m_movementProgress = 0.0;
+    m_movementStepSize = 0.0;
+    m_wasReset = false;
+}
+
+void MouseRun::setColor(int x, int y, Color color) {
+    m_view->getMazeGraphic()->setColor(x, y, color);
+    m_tilesWithColor.insert({x, y});
+}
+
+void MouseRun::clearColor(int x, int y) {
+    m_view->getMazeGraphic()->clearColor(x, y);
+    m_tilesWithColor -= {x, y};
+}
+
+void MouseRun::clearAllColor() {
+    for (QPair<int, int> position : m_tilesWithColor) {
+        m_view->getMazeGraphic()->clearColor(position.first, position.second);
+    }
+    m_tilesWithColor.clear();
+}
+
+void MouseRun::setText(int x, int y, const QString& text) {
+    m_view->getMazeGraphic()->setText(x, y, text);
+    m_tilesWithText.insert({x, y});
+}
+
+void MouseRun::clearText(int x, int y) {
+    m_view->getMazeGraphic()->clearText(x, y);
+    m_tilesWithText -= {x, y};
+}
+
+void MouseRun::clearAllText() {
+    for (QPair<int, int> position : m_tilesWithText) {
+        m_view->getMazeGraphic()->clearText(position.first, position.second);
+    }
+    m_tilesWithText.clear();
+}
+
+}
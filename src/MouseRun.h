@@ -0,0 +1,180 @@
+#pragma once
+
+#include <QByteArray>
+#include <QPair>
+#include <QProcess>
+#include <QQueue>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "Color.h"
+#include "CommandParser.h"
+#include "Direction.h"
+#include "Maze.h"
+#include "MazeView.h"
+#include "Mouse.h"
+#include "MouseGraphic.h"
+#include "World.h"
+
+namespace mms {
+
+enum class Movement {
+    MOVE_FORWARD,
+    TURN_RIGHT,
+    TURN_LEFT,
+    NONE,
+};
+
+// Everything about one mouse in the maze: the algorithm's process (if any),
+// the algorithm's own view of the maze, the mouse itself, and the commands
+// that are waiting to be performed. Several runs can share a maze. The run
+// owns all of it.
+class MouseRun {
+
+public:
+
+    MouseRun(const Maze* maze, const QString& name, Color bodyColor);
+    ~MouseRun();
+
+    QString getName() const;
+    Mouse* getMouse() const;
+    MazeView* getView() const;
+    MouseGraphic* getMouseGraphic() const;
+
+    // Null once the algorithm has exited, or for replays; the run takes
+    // ownership of the process
+    QProcess* getProcess() const;
+    void setProcess(QProcess* process);
+    void deleteProcess();
+
+    // Null until the algorithm drives the wheels of the mouse, after which
+    // the mouse follows the continuous simulation rather than moving a tile
+    // at a time. The world starts from wherever the mouse is, and starting
+    // it is a no-op if it's already started; stopping it leaves the mouse
+    // where the simulation put it.
+    World* getWorld() const;
+    World* startWorld();
+    void stopWorld();
+    bool hasCrashed() const;
+    void setHasCrashed(bool hasCrashed);
+
+    bool wasReset() const;
+    void setWasReset(bool wasReset);
+    bool isRecorded() const;
+    void setIsRecorded(bool isRecorded);
+    bool hasFailed() const;
+    void setHasFailed(bool hasFailed);
+
+    // ----- Output -----
+
+    // Incomplete lines of the algorithm's stderr
+    QStringList* getLogBuffer();
+
+    // Output that hasn't been dispatched yet: incomplete lines, and complete
+    // lines that are waiting for the run's next turn. Timestamps are in
+    // CommandStats::now() nanoseconds.
+    void appendOutput(const QByteArray& output, qint64 time);
+    qint64 getOutputArrivalTime() const;
+
+    // Whether there are complete lines of output waiting to be dispatched
+    bool hasPendingCommands() const;
+
+    // Points to the next complete line, without its newline, and marks it as
+    // dispatched; returns false if there isn't one. The line is valid until
+    // the output changes.
+    bool takeCommandLine(const char** line, int* length);
+
+    // Drops the dispatched lines, keeping everything after them to be
+    // combined with future output
+    void compactOutput();
+    void clearOutput();
+
+    // ----- Command queue -----
+
+    // Commands that elicit a response, performed one at a time, and the
+    // timestamps at which they arrived
+    void enqueueCommand(const Command& command, qint64 time);
+    bool hasQueuedCommands() const;
+    const Command& getQueuedCommand() const;
+    qint64 getQueuedCommandTime() const;
+    void dequeueCommand();
+
+    // Clears the queue and stops the timer
+    void clearCommandQueue();
+
+    // Fires when the queue should be processed again
+    QTimer* getCommandQueueTimer() const;
+
+    // ----- Movement -----
+
+    // The tile-at-a-time movement in progress, if any, from the starting
+    // location and direction
+    Movement getMovement() const;
+    void setMovement(Movement movement);
+    QPair<int, int> getStartingLocation() const;
+    Direction getStartingDirection() const;
+    double getMovementProgress() const;
+    void addMovementProgress(double progress);
+    double getMovementStepSize() const;
+    void setMovementStepSize(double movementStepSize);
+
+    // In CommandStats::now() nanoseconds
+    qint64 getMovementStartTime() const;
+    void setMovementStartTime(qint64 time);
+
+    // Starts the next movement from wherever the mouse is now
+    void finishMovement();
+
+    // Puts the mouse back at the start, with no movement in progress
+    void reset();
+
+    // ----- Visualization -----
+
+    // Keep track of the tiles with color or text, so that they can all be
+    // cleared at once
+    void setColor(int x, int y, Color color);
+    void clearColor(int x, int y);
+    void clearAllColor();
+    void setText(int x, int y, const QString& text);
+    void clearText(int x, int y);
+    void clearAllText();
+
+private:
+
+    QString m_name;
+    QProcess* m_process;
+    Mouse* m_mouse;
+    MazeView* m_view;
+    MouseGraphic* m_mouseGraphic;
+    const Maze* m_maze;
+
+    World* m_world;
+    bool m_hasCrashed;
+
+    bool m_wasReset;
+    bool m_isRecorded;
+    bool m_hasFailed;
+
+    QStringList m_logBuffer;
+    QByteArray m_commandBuffer;
+    int m_commandBufferStart;
+    qint64 m_outputArrivalTime;
+
+    QQueue<Command> m_commandQueue;
+    QQueue<qint64> m_commandQueueTimes;
+    QTimer* m_commandQueueTimer;
+
+    QPair<int, int> m_startingLocation;
+    Direction m_startingDirection;
+    Movement m_movement;
+    double m_movementProgress;
+    double m_movementStepSize;
+    qint64 m_movementStartTime;
+
+    QSet<QPair<int, int>> m_tilesWithColor;
+    QSet<QPair<int, int>> m_tilesWithText;
+};
+
+}
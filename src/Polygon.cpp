@@ -1,113 +1,216 @@
 #include "Polygon.h"
 
+#include <QMap>
+#include <QMutex>
 #include <QtMath>
 
 #include "AssertMacros.h"
 #include "GeometryUtilities.h"
-#include "SimUtilities.h"
 #include "polypartition/polypartition.h"
 
 namespace mms {
 
+const int Polygon::TRIANGULATION_CACHE_SIZE = 1024;
+
 Polygon::Polygon() {
 }
 
-Polygon::Polygon(const Polygon& polygon) :
-    m_vertices(polygon.getVertices()) {
-    // If the polygon being copyed has already been triangulated, we should
-    // grab the triangles, lest we have to re-triangulate in the future. If not,
-    // we can be lazy, in case the triangles for this polygon aren't needed.
-    if (polygon.alreadyPerformedTriangulation()) {
-        m_triangles = polygon.getTriangles();
-    }
-    else {
-        // Uncomment to log untriangulated polygon copies
-        /*
-        static int i = 0;
-        i += 1;
-        if (i % 100 == 0) {
-            qInfo().noquote().nospace()
-                << "Untriangulated polygon copies count: %v", i);
-        }
-        */
+Polygon::Polygon(const QVector<Coordinate>& vertices) {
+    ASSERT_LE(3, vertices.size());
+    m_vertices.resize(vertices.size());
+    for (int i = 0; i < vertices.size(); i += 1) {
+        m_vertices[i] = vertices.at(i);
     }
-}
-
-Polygon::Polygon(QVector<Coordinate> vertices) :
-    m_vertices(vertices),
-    // Postpone triangulation until we absolutely have to do it.
-    m_triangles({}) {
-    ASSERT_LE(3, m_vertices.size());
-    // If the number of vertices is three, the triangulation is trivial
+    // Postpone triangulation until we absolutely have to do it, unless the
+    // number of vertices is three, in which case the triangulation is trivial
     if (m_vertices.size() == 3) {
-        m_triangles = {{
+        m_triangles.append({
             m_vertices.at(0),
             m_vertices.at(1),
             m_vertices.at(2),
-        }};
+        });
     }
 }
 
-QVector<Coordinate> Polygon::getVertices() const {
+const Polygon::Vertices& Polygon::getVertices() const {
     return m_vertices;
 }
 
-QVector<Triangle> Polygon::getTriangles() const {
+const Polygon::Triangles& Polygon::getTriangles() const {
     // Lazy initialization here
-    if (m_triangles.size() == 0) {
-        m_triangles = triangulate(m_vertices);
+    if (!alreadyPerformedTriangulation()) {
+        triangulate(m_vertices, &m_triangles);
     }
     return m_triangles;
 }
 
-Polygon Polygon::translate(const Coordinate& translation) const {
+void Polygon::translate(const Coordinate& translation, Polygon* output) const {
 
-    QVector<Coordinate> vertices;
-    for (const Coordinate& vertex : m_vertices) {
-        vertices.append(GeometryUtilities::translateVertex(vertex, translation));
+    // Each output element only depends on the corresponding input element,
+    // so this is correct even if the output is this polygon
+    output->m_vertices.resize(m_vertices.size());
+    for (int i = 0; i < m_vertices.size(); i += 1) {
+        output->m_vertices[i] = GeometryUtilities::translateVertex(
+            m_vertices[i], translation);
     }
 
-    QVector<Triangle> triangles;
-    for (const Triangle& triangle : m_triangles) {
-        triangles.append({
+    output->m_triangles.resize(m_triangles.size());
+    for (int i = 0; i < m_triangles.size(); i += 1) {
+        const Triangle& triangle = m_triangles[i];
+        output->m_triangles[i] = {
             GeometryUtilities::translateVertex(triangle.p1, translation),
             GeometryUtilities::translateVertex(triangle.p2, translation),
             GeometryUtilities::translateVertex(triangle.p3, translation),
-        });
+        };
     }
+}
 
-    return Polygon(vertices, triangles);
+void Polygon::rotateAroundPoint(
+        const Angle& angle,
+        const Coordinate& point,
+        Polygon* output) const {
+
+    // Compute the rotation once, rather than converting each vertex to polar
+    // coordinates and back
+    double cos = angle.getCos();
+    double sin = angle.getSin();
+    double px = point.getX().getMeters();
+    double py = point.getY().getMeters();
+    auto rotate = [&](const Coordinate& vertex) {
+        double dx = vertex.getX().getMeters() - px;
+        double dy = vertex.getY().getMeters() - py;
+        return Coordinate::Cartesian(
+            Distance::Meters(px + dx * cos - dy * sin),
+            Distance::Meters(py + dx * sin + dy * cos)
+        );
+    };
+
+    // As with translate, this is correct even if the output is this polygon
+    output->m_vertices.resize(m_vertices.size());
+    for (int i = 0; i < m_vertices.size(); i += 1) {
+        output->m_vertices[i] = rotate(m_vertices[i]);
+    }
+
+    output->m_triangles.resize(m_triangles.size());
+    for (int i = 0; i < m_triangles.size(); i += 1) {
+        const Triangle& triangle = m_triangles[i];
+        output->m_triangles[i] = {
+            rotate(triangle.p1),
+            rotate(triangle.p2),
+            rotate(triangle.p3),
+        };
+    }
 }
 
-Polygon Polygon::rotateAroundPoint(const Angle& angle, const Coordinate& point) const {
+bool Polygon::alreadyPerformedTriangulation() const {
+    return 0 < m_triangles.size();
+}
 
-    QVector<Coordinate> vertices;
-    for (const Coordinate& vertex : m_vertices) {
-        vertices.append(GeometryUtilities::rotateVertexAroundPoint(vertex, point, angle));
+void Polygon::triangulate(const Vertices& vertices, Triangles* triangles) {
+
+    triangles->clear();
+
+    // Fast path: fan out from the first vertex
+    if (isConvex(vertices)) {
+        for (int i = 1; i + 1 < vertices.size(); i += 1) {
+            triangles->append({
+                vertices.at(0),
+                vertices.at(i),
+                vertices.at(i + 1),
+            });
+        }
+        return;
     }
 
-    QVector<Triangle> triangles;
-    for (const Triangle& triangle : m_triangles) {
-        triangles.append({
-            GeometryUtilities::rotateVertexAroundPoint(triangle.p1, point, angle),
-            GeometryUtilities::rotateVertexAroundPoint(triangle.p2, point, angle),
-            GeometryUtilities::rotateVertexAroundPoint(triangle.p3, point, angle),
+    QVector<int> indices = triangulateCached(vertices);
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        triangles->append({
+            vertices.at(indices.at(i)),
+            vertices.at(indices.at(i + 1)),
+            vertices.at(indices.at(i + 2)),
         });
     }
-
-    return Polygon(vertices, triangles);
 }
 
-Polygon::Polygon(QVector<Coordinate> vertices, QVector<Triangle> triangles) :
-    m_vertices(vertices),
-    m_triangles(triangles) {
+bool Polygon::isConvex(const Vertices& vertices) {
+
+    // A simple polygon is convex if it always turns the same way. Checking the
+    // turns alone would admit self-intersecting polygons like a pentagram, so
+    // we also require that the edges change direction along each axis no more
+    // than twice, which is true exactly when the polygon winds once.
+    int n = vertices.size();
+    int turnSign = 0;
+    int xSign = 0;
+    int ySign = 0;
+    int xFlips = 0;
+    int yFlips = 0;
+    for (int i = 0; i < n; i += 1) {
+        const Coordinate& a = vertices.at(i);
+        const Coordinate& b = vertices.at((i + 1) % n);
+        const Coordinate& c = vertices.at((i + 2) % n);
+        double abx = (b.getX() - a.getX()).getMeters();
+        double aby = (b.getY() - a.getY()).getMeters();
+        double bcx = (c.getX() - b.getX()).getMeters();
+        double bcy = (c.getY() - b.getY()).getMeters();
+
+        double cross = abx * bcy - aby * bcx;
+        int sign = (0 < cross) - (cross < 0);
+        if (sign != 0) {
+            if (turnSign != 0 && sign != turnSign) {
+                return false;
+            }
+            turnSign = sign;
+        }
+
+        int edgeXSign = (0 < abx) - (abx < 0);
+        if (edgeXSign != 0) {
+            xFlips += (xSign != 0 && edgeXSign != xSign) ? 1 : 0;
+            xSign = edgeXSign;
+        }
+        int edgeYSign = (0 < aby) - (aby < 0);
+        if (edgeYSign != 0) {
+            yFlips += (ySign != 0 && edgeYSign != ySign) ? 1 : 0;
+            ySign = edgeYSign;
+        }
+    }
+
+    // The flips were counted without wrapping around to the first edge, so a
+    // polygon that winds once has at most two of them along each axis
+    return turnSign != 0 && xFlips <= 2 && yFlips <= 2;
 }
 
-bool Polygon::alreadyPerformedTriangulation() const {
-    return 0 < m_triangles.size();
+QVector<int> Polygon::triangulateCached(const Vertices& vertices) {
+
+    static QMutex mutex;
+    static QMap<QVector<double>, QVector<int>> cache;
+
+    // The key is the shape of the polygon, i.e., the positions of the vertices
+    // relative to the first vertex, so that translated copies share an entry
+    QVector<double> key;
+    key.reserve(2 * vertices.size());
+    for (const Coordinate& vertex : vertices) {
+        key.append((vertex.getX() - vertices.at(0).getX()).getMeters());
+        key.append((vertex.getY() - vertices.at(0).getY()).getMeters());
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        if (cache.contains(key)) {
+            return cache.value(key);
+        }
+    }
+
+    QVector<int> indices = triangulateEarClipping(vertices);
+
+    QMutexLocker locker(&mutex);
+    if (TRIANGULATION_CACHE_SIZE <= cache.size()) {
+        cache.clear();
+    }
+    cache.insert(key, indices);
+    return indices;
 }
 
-QVector<Triangle> Polygon::triangulate(QVector<Coordinate> vertices) {
+QVector<int> Polygon::triangulateEarClipping(const Vertices& vertices) {
 
     // Populate the TPPLPoly
     TPPLPoly tpplPoly;
@@ -123,17 +226,25 @@ QVector<Triangle> Polygon::triangulate(QVector<Coordinate> vertices) {
     std::list<TPPLPoly> result;
     triangulator.Triangulate_EC(&tpplPoly, &result);
 
-    // Populate the output vector
-    QVector<Triangle> triangles;
+    // The output points are copies of the input points, so we can find which
+    // vertex each one came from by comparing them exactly
+    QVector<int> indices;
     for (auto it = result.begin(); it != result.end(); it++) {
-        triangles.append({
-            Coordinate::Cartesian(Distance::Meters((*it)[0].x), Distance::Meters((*it)[0].y)),
-            Coordinate::Cartesian(Distance::Meters((*it)[1].x), Distance::Meters((*it)[1].y)),
-            Coordinate::Cartesian(Distance::Meters((*it)[2].x), Distance::Meters((*it)[2].y)),
-        });
+        for (int i = 0; i < 3; i += 1) {
+            int index = 0;
+            while (
+                index < vertices.size() - 1 && (
+                    vertices.at(index).getX().getMeters() != (*it)[i].x ||
+                    vertices.at(index).getY().getMeters() != (*it)[i].y
+                )
+            ) {
+                index += 1;
+            }
+            indices.append(index);
+        }
     }
 
-    return triangles;
+    return indices;
 }
 
 } 
@@ -2,6 +2,7 @@
 
 #include <QVector>
 
+#include "SmallVector.h"
 #include "Triangle.h"
 #include "units/Angle.h"
 #include "units/Coordinate.h"
@@ -12,38 +13,58 @@ class Polygon {
 
 public:
 
-    Polygon();
-    Polygon(const Polygon& polygon);
-    Polygon(QVector<Coordinate> vertices);
-
-    QVector<Coordinate> getVertices() const;
-    QVector<Triangle> getTriangles() const;
+    // Polygons with at most this many vertices (i.e., every polygon that the
+    // simulator draws) are stored inline, and can be copied, moved, and
+    // transformed without any heap allocations
+    static const int MAX_INLINE_VERTICES = 8;
+    typedef SmallVector<Coordinate, MAX_INLINE_VERTICES> Vertices;
+    typedef SmallVector<Triangle, MAX_INLINE_VERTICES - 2> Triangles;
 
-    Polygon translate(const Coordinate& translation) const;
-    Polygon rotateAroundPoint(const Angle& angle, const Coordinate& point) const;
+    Polygon();
+    Polygon(const Polygon& polygon) = default;
+    Polygon(Polygon&& polygon) = default;
+    Polygon(const QVector<Coordinate>& vertices);
+    Polygon& operator=(const Polygon& polygon) = default;
+    Polygon& operator=(Polygon&& polygon) = default;
+
+    const Vertices& getVertices() const;
+    const Triangles& getTriangles() const;
+
+    // Write the transformed polygon into output, reusing its storage. The
+    // output may be this polygon, so that transforms can be chained in place.
+    void translate(const Coordinate& translation, Polygon* output) const;
+    void rotateAroundPoint(
+        const Angle& angle,
+        const Coordinate& point,
+        Polygon* output) const;
 
 private:
 
-    QVector<Coordinate> m_vertices;
+    Vertices m_vertices;
 
     // We're lazy about triangulation, since it's expensive and not always
     // necessary. The "mutable" keyword allows us to assign m_triangles in the
-    // const function getTriangles().
-    mutable QVector<Triangle> m_triangles;
-
-    // This special constructor makes it so that rotate and translate don't
-    // require re-triangulation. We keep it private since it's pretty easy to
-    // abuse the fact that the triangles argument should be the triangulation
-    // of the polygon specified by the vertices argument.
-    Polygon(QVector<Coordinate> vertices, QVector<Triangle> triangles);
-
-    // Tells us whether or not the polygon has already performed triangulation.
-    // This is used in the copy constructor, and allows us to be lazy without
-    // throwing away information.
+    // const function getTriangles(). Transforms carry the triangles along, so
+    // that transformed polygons don't require re-triangulation.
+    mutable Triangles m_triangles;
+
+    // Tells us whether or not the polygon has already performed triangulation
     bool alreadyPerformedTriangulation() const;
 
     // Actually peforms the triangulation of the polygon.
-    static QVector<Triangle> triangulate(QVector<Coordinate> vertices);
+    static void triangulate(const Vertices& vertices, Triangles* triangles);
+
+    // Triangulations are computed as indices into the vertices, three per
+    // triangle, since those don't change when the polygon is translated.
+    // Convex polygons, which includes every rectangle, are trivially
+    // triangulated as a fan; everything else goes through ear clipping, the
+    // results of which are cached by the shape of the polygon.
+    static bool isConvex(const Vertices& vertices);
+    static QVector<int> triangulateCached(const Vertices& vertices);
+    static QVector<int> triangulateEarClipping(const Vertices& vertices);
+
+    // The maximum number of shapes in the triangulation cache
+    static const int TRIANGULATION_CACHE_SIZE;
 
 };
 
@@ -0,0 +1,129 @@
+#include "RayCaster.h"
+
+#include <QtMath>
+
+#include <limits>
+
+#include "Dimensions.h"
+
+namespace mms {
+
+double RayCaster::cast(const WallGrid& grid, const Ray& ray) {
+    return traverse(grid, ray, setUp(ray));
+}
+
+QVector<double> RayCaster::cast(
+        const WallGrid& grid,
+        const QVector<Ray>& rays) {
+
+    // Set up every ray before traversing any of them, so that the arithmetic
+    // is done in one tight loop, rather than interleaved with the branches of
+    // the traversals
+    QVector<Traversal> traversals(rays.size());
+    for (int i = 0; i < rays.size(); i += 1) {
+        traversals[i] = setUp(rays.at(i));
+    }
+    QVector<double> distances(rays.size());
+    for (int i = 0; i < rays.size(); i += 1) {
+        distances[i] = traverse(grid, rays.at(i), traversals.at(i));
+    }
+    return distances;
+}
+
+RayCaster::Traversal RayCaster::setUp(const Ray& ray) {
+
+    static const double halfWallWidth = Dimensions::halfWallWidth().getMeters();
+    static const double tileLength = Dimensions::tileLength().getMeters();
+    static const double infinity = std::numeric_limits<double>::infinity();
+
+    // Rays stop at the near face of a wall, not at its center, so the
+    // boundaries are shifted by half a wall width towards the ray. The tiles
+    // are shifted along with them, which only matters within a post, where
+    // the ray stops regardless.
+    Traversal traversal;
+    traversal.stepX = 0 < ray.dx ? 1 : -1;
+    traversal.stepY = 0 < ray.dy ? 1 : -1;
+    double shiftX = -halfWallWidth * traversal.stepX;
+    double shiftY = -halfWallWidth * traversal.stepY;
+    traversal.tileX = qFloor((ray.x - shiftX) / tileLength);
+    traversal.tileY = qFloor((ray.y - shiftY) / tileLength);
+
+    // A ray that's parallel to an axis never crosses its boundaries
+    traversal.nextX = infinity;
+    traversal.deltaX = infinity;
+    if (ray.dx != 0.0) {
+        double boundary =
+            tileLength * (traversal.tileX + (0 < ray.dx ? 1 : 0)) + shiftX;
+        traversal.nextX = (boundary - ray.x) / ray.dx;
+        traversal.deltaX = tileLength / qAbs(ray.dx);
+    }
+    traversal.nextY = infinity;
+    traversal.deltaY = infinity;
+    if (ray.dy != 0.0) {
+        double boundary =
+            tileLength * (traversal.tileY + (0 < ray.dy ? 1 : 0)) + shiftY;
+        traversal.nextY = (boundary - ray.y) / ray.dy;
+        traversal.deltaY = tileLength / qAbs(ray.dy);
+    }
+    return traversal;
+}
+
+double RayCaster::traverse(
+        const WallGrid& grid,
+        const Ray& ray,
+        Traversal traversal) {
+
+    const unsigned char* walls = grid.data();
+    int width = grid.getWidth();
+    int height = grid.getHeight();
+    unsigned char wallX = WallGrid::bit(
+        0 < traversal.stepX ? Direction::EAST : Direction::WEST);
+    unsigned char wallY = WallGrid::bit(
+        0 < traversal.stepY ? Direction::NORTH : Direction::SOUTH);
+
+    // Cross whichever boundary comes first, until the end of the ray. There
+    // are no walls outside of the maze, but there are still posts, same as in
+    // the old simulator.
+    while (true) {
+        bool isWithinMaze =
+            0 <= traversal.tileX && traversal.tileX < width &&
+            0 <= traversal.tileY && traversal.tileY < height;
+        unsigned char tile = isWithinMaze ?
+            walls[height * traversal.tileX + traversal.tileY] : 0;
+        if (traversal.nextX < traversal.nextY) {
+            if (ray.length < traversal.nextX) {
+                return ray.length;
+            }
+            if (
+                (tile & wallX) != 0 ||
+                isOnPost(ray.y + traversal.nextX * ray.dy)
+            ) {
+                return traversal.nextX;
+            }
+            traversal.tileX += traversal.stepX;
+            traversal.nextX += traversal.deltaX;
+        }
+        else {
+            if (ray.length < traversal.nextY) {
+                return ray.length;
+            }
+            if (
+                (tile & wallY) != 0 ||
+                isOnPost(ray.x + traversal.nextY * ray.dx)
+            ) {
+                return traversal.nextY;
+            }
+            traversal.tileY += traversal.stepY;
+            traversal.nextY += traversal.deltaY;
+        }
+    }
+}
+
+bool RayCaster::isOnPost(double position) {
+    static const double halfWallWidth = Dimensions::halfWallWidth().getMeters();
+    static const double tileLength = Dimensions::tileLength().getMeters();
+    double offset = position - tileLength * qFloor(position / tileLength);
+    return offset < halfWallWidth || tileLength - halfWallWidth < offset;
+}
+
+}
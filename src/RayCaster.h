@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QVector>
+
+#include "WallGrid.h"
+
+namespace mms {
+
+// Casts rays against the walls and posts of a maze. A ray is traversed a tile
+// at a time (the DDA of Amanatides and Woo), and only the tile boundaries that
+// it crosses are checked, so its cost is proportional to the number of tiles
+// that it crosses rather than to the size of the maze. Lengths are in meters.
+class RayCaster {
+
+public:
+
+    // The RayCaster class is not constructible
+    RayCaster() = delete;
+
+    struct Ray {
+        double x;
+        double y;
+        // The direction of the ray, as a unit vector
+        double dx;
+        double dy;
+        double length;
+    };
+
+    // Returns the distance along the ray to the first wall or post that it
+    // hits, or the length of the ray if it doesn't hit anything
+    static double cast(const WallGrid& grid, const Ray& ray);
+
+    // Casts many rays at once, e.g., every ray of every sensor of a mouse, and
+    // returns their distances in the same order
+    static QVector<double> cast(const WallGrid& grid, const QVector<Ray>& rays);
+
+private:
+
+    // The state of the traversal of a single ray: the tile that it's in, the
+    // direction that it steps in, and the distances along the ray to the next
+    // boundaries and between boundaries, for each axis
+    struct Traversal {
+        int tileX;
+        int tileY;
+        int stepX;
+        int stepY;
+        double nextX;
+        double nextY;
+        double deltaX;
+        double deltaY;
+    };
+
+    static Traversal setUp(const Ray& ray);
+    static double traverse(
+        const WallGrid& grid,
+        const Ray& ray,
+        Traversal traversal);
+
+    // Whether a position along a tile boundary is within a post
+    static bool isOnPost(double position);
+};
+
+}
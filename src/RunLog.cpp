@@ -0,0 +1,88 @@
+#include "RunLog.h"
+
+#include <QMutexLocker>
+
+namespace mms {
+
+const int RunLog::CAPACITY = 10000;
+
+RunLog::RunLog() :
+    m_lines(CAPACITY),
+    m_first(0),
+    m_count(0),
+    m_dropped(0) {
+}
+
+bool RunLog::start(const QString& path) {
+    QMutexLocker locker(&m_mutex);
+    m_first = 0;
+    m_count = 0;
+    m_dropped = 0;
+    if (m_file.isOpen()) {
+        m_stream.flush();
+        m_file.close();
+    }
+    if (path.isEmpty()) {
+        return true;
+    }
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    m_stream.setDevice(&m_file);
+    return true;
+}
+
+void RunLog::stop() {
+    QMutexLocker locker(&m_mutex);
+    if (m_file.isOpen()) {
+        m_stream.flush();
+        m_file.close();
+    }
+}
+
+void RunLog::append(const QString& line) {
+    QMutexLocker locker(&m_mutex);
+    appendLocked(line);
+}
+
+void RunLog::append(const QStringList& lines) {
+    QMutexLocker locker(&m_mutex);
+    for (const QString& line : lines) {
+        appendLocked(line);
+    }
+}
+
+QStringList RunLog::take(int* dropped) {
+    QStringList lines;
+    QMutexLocker locker(&m_mutex);
+    lines.reserve(m_count);
+    for (int i = 0; i < m_count; i += 1) {
+        // Swapping leaves an empty string behind, so nothing is copied
+        lines.append(QString());
+        lines.last().swap(m_lines[(m_first + i) % CAPACITY]);
+    }
+    *dropped = m_dropped;
+    m_first = 0;
+    m_count = 0;
+    m_dropped = 0;
+    return lines;
+}
+
+void RunLog::appendLocked(const QString& line) {
+    if (m_file.isOpen()) {
+        m_stream << line << '\n';
+    }
+    if (m_count < CAPACITY) {
+        m_lines[(m_first + m_count) % CAPACITY] = line;
+        m_count += 1;
+    }
+    else {
+        // Overwrite the oldest line
+        m_lines[m_first] = line;
+        m_first = (m_first + 1) % CAPACITY;
+        m_dropped += 1;
+    }
+}
+
+}
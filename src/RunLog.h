@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+namespace mms {
+
+// Collects the lines that an algorithm prints in a bounded ring buffer, from
+// which the GUI takes them in batches, at most once per frame. If the lines
+// come in faster than they're taken, the oldest ones are dropped (only the
+// most recent lines fit in the view anyway). Every line can also be written
+// to a file, so that nothing is lost.
+class RunLog {
+
+public:
+
+    // The most lines that are kept until they're taken
+    static const int CAPACITY;
+
+    RunLog();
+
+    // Clears the buffer and, if the path is nonempty, starts writing every
+    // line to that file; returns false if the file couldn't be opened
+    bool start(const QString& path);
+
+    // Stops writing lines to the file, if any
+    void stop();
+
+    // May be called from any thread
+    void append(const QString& line);
+    void append(const QStringList& lines);
+
+    // Returns the lines appended since the last call, oldest first, and sets
+    // dropped to the number of lines that were overwritten before then
+    QStringList take(int* dropped);
+
+private:
+
+    QMutex m_mutex;
+    QVector<QString> m_lines;
+    int m_first;
+    int m_count;
+    int m_dropped;
+
+    QFile m_file;
+    QTextStream m_stream;
+
+    // Must be called with the mutex held
+    void appendLocked(const QString& line);
+};
+
+}
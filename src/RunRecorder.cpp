@@ -0,0 +1,201 @@
+#include "RunRecorder.h"
+
+#include "AssertMacros.h"
+
+namespace mms {
+
+const QByteArray RunRecorder::MAGIC = "MMSR";
+const int RunRecorder::VERSION = 2;
+const int RunRecorder::OPCODE_STRING = 64;
+const int RunRecorder::OPCODE_RESPONSE = 65;
+const int RunRecorder::CHUNK_SIZE = 64 * 1024;
+
+RunRecorder::RunRecorder() :
+    m_previousTimestamp(0),
+    m_isStopping(false),
+    m_writer(nullptr) {
+}
+
+RunRecorder::~RunRecorder() {
+    stop();
+}
+
+bool RunRecorder::start(
+        const QString& path,
+        const QString& mazeFile,
+        int mazeWidth,
+        int mazeHeight) {
+
+    stop();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    m_chunk.clear();
+    m_chunk.reserve(CHUNK_SIZE);
+    m_previousTimestamp = 0;
+    m_stringIds.clear();
+    m_chunk.append(MAGIC);
+    appendVarint(&m_chunk, VERSION);
+    appendString(mazeFile);
+    appendVarint(&m_chunk, mazeWidth);
+    appendVarint(&m_chunk, mazeHeight);
+
+    m_isStopping = false;
+    m_writer = new std::thread(&RunRecorder::run, this);
+    return true;
+}
+
+void RunRecorder::stop() {
+    if (m_writer == nullptr) {
+        return;
+    }
+    handOff();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_wake.notify_one();
+    m_writer->join();
+    delete m_writer;
+    m_writer = nullptr;
+    m_file.close();
+}
+
+bool RunRecorder::isRecording() const {
+    return m_writer != nullptr;
+}
+
+void RunRecorder::recordCommand(const Command& command, qint64 timestamp) {
+    if (!isRecording()) {
+        return;
+    }
+
+    // The text must be defined before the command that refers to it
+    const CommandSpec& spec = CommandParser::getSpec(command.type);
+    int textId = 0;
+    if (spec.arguments == CommandArguments::POSITION_TEXT) {
+        textId = intern(command.text);
+    }
+
+    appendVarint(&m_chunk, static_cast<int>(command.type));
+    appendTimestamp(timestamp);
+    switch (spec.arguments) {
+        case CommandArguments::NONE:
+            break;
+        case CommandArguments::POSITION:
+        case CommandArguments::SPEEDS:
+            appendVarint(&m_chunk, zigzag(command.x));
+            appendVarint(&m_chunk, zigzag(command.y));
+            break;
+        case CommandArguments::POSITION_DIRECTION:
+        case CommandArguments::POSITION_COLOR:
+            appendVarint(&m_chunk, zigzag(command.x));
+            appendVarint(&m_chunk, zigzag(command.y));
+            m_chunk.append(command.character.toLatin1());
+            break;
+        case CommandArguments::POSITION_TEXT:
+            appendVarint(&m_chunk, zigzag(command.x));
+            appendVarint(&m_chunk, zigzag(command.y));
+            appendVarint(&m_chunk, textId);
+            break;
+    }
+
+    if (CHUNK_SIZE <= m_chunk.size()) {
+        handOff();
+    }
+}
+
+void RunRecorder::recordResponse(const QString& response, qint64 timestamp) {
+    if (!isRecording()) {
+        return;
+    }
+    int responseId = intern(response);
+    appendVarint(&m_chunk, OPCODE_RESPONSE);
+    appendTimestamp(timestamp);
+    appendVarint(&m_chunk, responseId);
+    if (CHUNK_SIZE <= m_chunk.size()) {
+        handOff();
+    }
+}
+
+void RunRecorder::appendVarint(QByteArray* bytes, quint64 value) {
+    while (0x80 <= value) {
+        bytes->append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    bytes->append(static_cast<char>(value));
+}
+
+quint64 RunRecorder::zigzag(qint64 value) {
+    // Small negative numbers become small positive numbers
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+void RunRecorder::appendTimestamp(qint64 timestamp) {
+    // The clock is monotonic, but guard against it anyway
+    qint64 delta = timestamp - m_previousTimestamp;
+    if (m_previousTimestamp == 0 || delta < 0) {
+        delta = 0;
+    }
+    appendVarint(&m_chunk, delta);
+    m_previousTimestamp = timestamp;
+}
+
+void RunRecorder::appendString(const QString& string) {
+    QByteArray bytes = string.toUtf8();
+    appendVarint(&m_chunk, bytes.size());
+    m_chunk.append(bytes);
+}
+
+int RunRecorder::intern(const QString& string) {
+    QHash<QString, int>::const_iterator it = m_stringIds.constFind(string);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+    int id = m_stringIds.size();
+    m_stringIds.insert(string, id);
+    appendVarint(&m_chunk, OPCODE_STRING);
+    appendString(string);
+    return id;
+}
+
+void RunRecorder::handOff() {
+    if (m_chunk.isEmpty()) {
+        return;
+    }
+    QByteArray chunk;
+    chunk.reserve(CHUNK_SIZE);
+    chunk.swap(m_chunk);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.append(chunk);
+    }
+    m_wake.notify_one();
+}
+
+void RunRecorder::run() {
+    QVector<QByteArray> chunks;
+    while (true) {
+        bool isStopping = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this](){
+                return m_isStopping || !m_pending.isEmpty();
+            });
+            chunks.swap(m_pending);
+            isStopping = m_isStopping;
+        }
+        for (const QByteArray& chunk : chunks) {
+            m_file.write(chunk);
+        }
+        chunks.clear();
+        if (isStopping) {
+            break;
+        }
+    }
+    m_file.flush();
+}
+
+}
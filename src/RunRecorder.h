@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "CommandParser.h"
+
+namespace mms {
+
+// Records every command that an algorithm sends, and every response that it
+// gets, so that a run can be reproduced without the algorithm. Records are
+// encoded on the calling thread into an in-memory chunk, which is handed to a
+// background thread to be written whenever it fills up.
+//
+// A recording is a header followed by records. All integers are unsigned
+// LEB128 varints, and signed integers are zigzag-encoded first. The header is
+// MAGIC, VERSION, the maze file path (a string), and the maze width and
+// height. Each record starts with an opcode:
+//
+//     0 to NUM_COMMAND_TYPES - 1: a command of that CommandType, followed by
+//         the nanoseconds since the previous timed record, and its arguments:
+//         signed x and y, a direction or color byte, and/or a text string id
+//     OPCODE_STRING: the next string id, followed by a string
+//     OPCODE_RESPONSE: the nanoseconds since the previous timed record,
+//         followed by the id of the response string
+//
+// A string is its length followed by its UTF-8 bytes. Every distinct string
+// is written just once, the first time it's used, and then referred to by id.
+//
+// The opcodes of commands are their CommandTypes, so VERSION goes up whenever
+// COMMAND_LIST changes, and replays only accept recordings of their version.
+class RunRecorder {
+
+public:
+
+    static const QByteArray MAGIC;
+    static const int VERSION;
+    static const int OPCODE_STRING;
+    static const int OPCODE_RESPONSE;
+
+    RunRecorder();
+    ~RunRecorder();
+
+    // Starts a new recording, stopping the current one if necessary; returns
+    // false if the file couldn't be opened
+    bool start(
+        const QString& path,
+        const QString& mazeFile,
+        int mazeWidth,
+        int mazeHeight);
+
+    // Writes everything that's been recorded, and closes the file
+    void stop();
+
+    bool isRecording() const;
+
+    // Timestamps are in CommandStats::now() nanoseconds. These must be called
+    // from one thread at a time.
+    void recordCommand(const Command& command, qint64 timestamp);
+    void recordResponse(const QString& response, qint64 timestamp);
+
+    static void appendVarint(QByteArray* bytes, quint64 value);
+    static quint64 zigzag(qint64 value);
+
+private:
+
+    // How large the chunk gets before it's handed to the writer thread
+    static const int CHUNK_SIZE;
+
+    QFile m_file;
+    QByteArray m_chunk;
+    qint64 m_previousTimestamp;
+    QHash<QString, int> m_stringIds;
+
+    // Chunks waiting for the writer thread
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    QVector<QByteArray> m_pending;
+    bool m_isStopping;
+    std::thread* m_writer;
+
+    void appendTimestamp(qint64 timestamp);
+    void appendString(const QString& string);
+    int intern(const QString& string);
+    void handOff();
+    void run();
+};
+
+}
@@ -0,0 +1,521 @@
+#include "RunReplay.h"
+
+#include <QFile>
+
+#include <limits>
+
+#include "AssertMacros.h"
+#include "Color.h"
+#include "Dimensions.h"
+#include "RunRecorder.h"
+
+namespace mms {
+
+const double RunReplay::MAX_SPEED = std::numeric_limits<double>::infinity();
+const int RunReplay::KEYFRAME_INTERVAL = 1024;
+const double RunReplay::MAX_SPEED_COMMANDS_PER_SECOND = 60000.0;
+
+RunReplay* RunReplay::fromFile(const QString& path, const Maze* maze) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    RunReplay* replay = new RunReplay(maze);
+    if (!replay->load(file.readAll())) {
+        delete replay;
+        return nullptr;
+    }
+    return replay;
+}
+
+RunReplay::RunReplay(const Maze* maze) :
+    m_maze(maze),
+    m_position(0),
+    m_time(0),
+    m_maxSpeedCommands(0.0),
+    m_graphic(nullptr),
+    m_mouse(nullptr) {
+}
+
+QString RunReplay::getMazeFile() const {
+    return m_mazeFile;
+}
+
+int RunReplay::getNumCommands() const {
+    return m_commands.size();
+}
+
+int RunReplay::getPosition() const {
+    return m_position;
+}
+
+bool RunReplay::isFinished() const {
+    return m_position == m_commands.size();
+}
+
+void RunReplay::attach(MazeGraphic* graphic, Mouse* mouse) {
+    m_graphic = graphic;
+    m_mouse = mouse;
+    // A new view shows no walls, colors, or text
+    m_shown = getInitialState();
+    m_shown.x = -1;
+    show();
+}
+
+void RunReplay::seek(int position) {
+    ASSERT_FA(m_graphic == nullptr);
+    moveTo(qBound(0, position, m_commands.size()));
+    m_time = m_position == 0 ? 0 : m_timestamps.at(m_position - 1);
+    m_maxSpeedCommands = 0.0;
+    show();
+}
+
+void RunReplay::advance(double seconds, double speed) {
+    ASSERT_FA(m_graphic == nullptr);
+    int position = m_position;
+    if (speed == MAX_SPEED) {
+        // Carry over fractions of a command from frame to frame
+        m_maxSpeedCommands += seconds * MAX_SPEED_COMMANDS_PER_SECOND;
+        int count = static_cast<int>(m_maxSpeedCommands);
+        m_maxSpeedCommands -= count;
+        position = qMin(m_position + count, m_commands.size());
+        if (0 < position) {
+            m_time = m_timestamps.at(position - 1);
+        }
+    }
+    else {
+        m_time += static_cast<qint64>(seconds * speed * 1e9);
+        while (
+            position < m_commands.size() &&
+            m_timestamps.at(position) <= m_time
+        ) {
+            position += 1;
+        }
+    }
+    moveTo(position);
+    show();
+}
+
+bool RunReplay::load(const QByteArray& bytes) {
+
+    // The header
+    if (!bytes.startsWith(RunRecorder::MAGIC)) {
+        return false;
+    }
+    int offset = RunRecorder::MAGIC.size();
+    quint64 version = 0;
+    quint64 width = 0;
+    quint64 height = 0;
+    if (
+        !readVarint(bytes, &offset, &version) ||
+        version != static_cast<quint64>(RunRecorder::VERSION) ||
+        !readString(bytes, &offset, &m_mazeFile) ||
+        !readVarint(bytes, &offset, &width) ||
+        !readVarint(bytes, &offset, &height) ||
+        width != static_cast<quint64>(m_maze->getWidth()) ||
+        height != static_cast<quint64>(m_maze->getHeight())
+    ) {
+        return false;
+    }
+
+    // The records; responses are only timestamps to us, since replaying the
+    // commands in the same maze reproduces them
+    qint64 timestamp = 0;
+    while (offset < bytes.size()) {
+        quint64 opcode = 0;
+        quint64 delta = 0;
+        if (!readVarint(bytes, &offset, &opcode)) {
+            return false;
+        }
+        if (opcode == static_cast<quint64>(RunRecorder::OPCODE_STRING)) {
+            QString string;
+            if (!readString(bytes, &offset, &string)) {
+                return false;
+            }
+            // Every distinct string is recorded once, so ids are unique
+            m_textIds.insert(string, m_strings.size());
+            m_strings.append(string);
+            continue;
+        }
+        if (!readVarint(bytes, &offset, &delta)) {
+            return false;
+        }
+        timestamp += delta;
+        if (opcode == static_cast<quint64>(RunRecorder::OPCODE_RESPONSE)) {
+            quint64 id = 0;
+            if (!readVarint(bytes, &offset, &id)) {
+                return false;
+            }
+            continue;
+        }
+        if (static_cast<quint64>(NUM_COMMAND_TYPES) <= opcode) {
+            return false;
+        }
+
+        Command command = {
+            static_cast<CommandType>(opcode), 0, 0, QChar(), QString()
+        };
+        CommandArguments arguments =
+            CommandParser::getSpec(command.type).arguments;
+        if (arguments != CommandArguments::NONE) {
+            quint64 x = 0;
+            quint64 y = 0;
+            if (
+                !readVarint(bytes, &offset, &x) ||
+                !readVarint(bytes, &offset, &y)
+            ) {
+                return false;
+            }
+            command.x = unzigzag(x);
+            command.y = unzigzag(y);
+        }
+        if (
+            arguments == CommandArguments::POSITION_DIRECTION ||
+            arguments == CommandArguments::POSITION_COLOR
+        ) {
+            if (bytes.size() <= offset) {
+                return false;
+            }
+            command.character = QLatin1Char(bytes.at(offset));
+            offset += 1;
+        }
+        if (arguments == CommandArguments::POSITION_TEXT) {
+            quint64 id = 0;
+            if (
+                !readVarint(bytes, &offset, &id) ||
+                static_cast<quint64>(m_strings.size()) <= id
+            ) {
+                return false;
+            }
+            command.text = m_strings.at(id);
+        }
+        m_commands.append(command);
+        m_timestamps.append(timestamp);
+    }
+
+    // Play the whole recording once, to take the keyframes; the end of the
+    // recording is a position too, so it gets a keyframe if it falls on one
+    m_state = getInitialState();
+    for (int i = 0; i <= m_commands.size(); i += 1) {
+        if (i % KEYFRAME_INTERVAL == 0) {
+            m_keyframes.append(m_state);
+        }
+        if (i < m_commands.size()) {
+            apply(m_commands.at(i), &m_state);
+        }
+    }
+    m_state = getInitialState();
+    m_position = 0;
+    return true;
+}
+
+RunReplay::State RunReplay::getInitialState() const {
+    int numTiles = m_maze->getWidth() * m_maze->getHeight();
+    State state;
+    state.walls.fill(0, numTiles);
+    state.colors.fill(-1, numTiles);
+    state.texts.fill(-1, numTiles);
+    state.x = 0;
+    state.y = 0;
+    state.direction = Direction::NORTH;
+    state.isOnWheels = false;
+    return state;
+}
+
+void RunReplay::apply(const Command& command, State* state) const {
+    StateMouse mouse(m_maze, &m_textIds, state);
+    CommandDispatcher::execute(&mouse, command);
+}
+
+void RunReplay::moveTo(int position) {
+    // Playing forward from the current state is cheapest, unless there's a
+    // keyframe in between
+    int keyframe = position / KEYFRAME_INTERVAL;
+    if (position < m_position || m_position < keyframe * KEYFRAME_INTERVAL) {
+        m_state = m_keyframes.at(keyframe);
+        m_position = keyframe * KEYFRAME_INTERVAL;
+    }
+    while (m_position < position) {
+        apply(m_commands.at(m_position), &m_state);
+        m_position += 1;
+    }
+}
+
+void RunReplay::show() {
+
+    int height = m_maze->getHeight();
+    for (int i = 0; i < m_state.walls.size(); i += 1) {
+        int x = i / height;
+        int y = i % height;
+        quint8 walls = m_state.walls.at(i);
+        quint8 changed = walls ^ m_shown.walls.at(i);
+        for (int d = 0; changed != 0 && d < 4; d += 1) {
+            if (changed & (1 << d)) {
+                if (walls & (1 << d)) {
+                    m_graphic->setWall(x, y, static_cast<Direction>(d));
+                }
+                else {
+                    m_graphic->clearWall(x, y, static_cast<Direction>(d));
+                }
+            }
+        }
+        m_shown.walls[i] = walls;
+
+        int color = m_state.colors.at(i);
+        if (color != m_shown.colors.at(i)) {
+            if (color == -1) {
+                m_graphic->clearColor(x, y);
+            }
+            else {
+                m_graphic->setColor(x, y, static_cast<Color>(color));
+            }
+            m_shown.colors[i] = color;
+        }
+
+        int text = m_state.texts.at(i);
+        if (text != m_shown.texts.at(i)) {
+            if (text == -1) {
+                m_graphic->clearText(x, y);
+            }
+            else {
+                m_graphic->setText(x, y, m_strings.at(text));
+            }
+            m_shown.texts[i] = text;
+        }
+    }
+
+    if (
+        m_state.x != m_shown.x ||
+        m_state.y != m_shown.y ||
+        m_state.direction != m_shown.direction
+    ) {
+        m_mouse->teleport(
+            Coordinate::Cartesian(
+                Dimensions::tileLength() * (static_cast<double>(m_state.x) + 0.5),
+                Dimensions::tileLength() * (static_cast<double>(m_state.y) + 0.5)
+            ),
+            DIRECTION_TO_ANGLE().value(m_state.direction)
+        );
+        m_shown.x = m_state.x;
+        m_shown.y = m_state.y;
+        m_shown.direction = m_state.direction;
+    }
+}
+
+RunReplay::StateMouse::StateMouse(
+        const Maze* maze,
+        const QHash<QString, int>* textIds,
+        State* state) :
+    m_maze(maze),
+    m_textIds(textIds),
+    m_state(state) {
+}
+
+int RunReplay::StateMouse::mazeWidth() {
+    return m_maze->getWidth();
+}
+
+int RunReplay::StateMouse::mazeHeight() {
+    return m_maze->getHeight();
+}
+
+bool RunReplay::StateMouse::wallFront() {
+    return m_maze->isWall(m_state->x, m_state->y, m_state->direction);
+}
+
+bool RunReplay::StateMouse::wallRight() {
+    return m_maze->isWall(
+        m_state->x,
+        m_state->y,
+        DIRECTION_ROTATE_RIGHT().value(m_state->direction));
+}
+
+bool RunReplay::StateMouse::wallLeft() {
+    return m_maze->isWall(
+        m_state->x,
+        m_state->y,
+        DIRECTION_ROTATE_LEFT().value(m_state->direction));
+}
+
+QString RunReplay::StateMouse::moveForward() {
+    if (m_state->isOnWheels) {
+        return CommandDispatcher::ON_WHEELS;
+    }
+    if (wallFront()) {
+        return CommandDispatcher::CRASH;
+    }
+    switch (m_state->direction) {
+        case Direction::NORTH:
+            m_state->y += 1;
+            break;
+        case Direction::EAST:
+            m_state->x += 1;
+            break;
+        case Direction::SOUTH:
+            m_state->y -= 1;
+            break;
+        case Direction::WEST:
+            m_state->x -= 1;
+            break;
+    }
+    return CommandDispatcher::ACK;
+}
+
+QString RunReplay::StateMouse::turnRight() {
+    if (m_state->isOnWheels) {
+        return CommandDispatcher::ON_WHEELS;
+    }
+    m_state->direction = DIRECTION_ROTATE_RIGHT().value(m_state->direction);
+    return CommandDispatcher::ACK;
+}
+
+QString RunReplay::StateMouse::turnLeft() {
+    if (m_state->isOnWheels) {
+        return CommandDispatcher::ON_WHEELS;
+    }
+    m_state->direction = DIRECTION_ROTATE_LEFT().value(m_state->direction);
+    return CommandDispatcher::ACK;
+}
+
+void RunReplay::StateMouse::setWheelSpeeds(int, int) {
+    m_state->isOnWheels = true;
+}
+
+QPair<int, int> RunReplay::StateMouse::readEncoders() {
+    return {0, 0};
+}
+
+QVector<double> RunReplay::StateMouse::readSensors() {
+    return QVector<double>();
+}
+
+void RunReplay::StateMouse::setWall(int x, int y, QChar direction) {
+    updateWall(x, y, direction, true);
+}
+
+void RunReplay::StateMouse::clearWall(int x, int y, QChar direction) {
+    updateWall(x, y, direction, false);
+}
+
+void RunReplay::StateMouse::setColor(int x, int y, QChar color) {
+    if (isWithinMaze(x, y) && CHAR_TO_COLOR().contains(color)) {
+        m_state->colors[getIndex(x, y)] =
+            static_cast<int>(CHAR_TO_COLOR().value(color));
+    }
+}
+
+void RunReplay::StateMouse::clearColor(int x, int y) {
+    if (isWithinMaze(x, y)) {
+        m_state->colors[getIndex(x, y)] = -1;
+    }
+}
+
+void RunReplay::StateMouse::clearAllColor() {
+    m_state->colors.fill(-1);
+}
+
+void RunReplay::StateMouse::setText(int x, int y, const QString& text) {
+    if (isWithinMaze(x, y)) {
+        m_state->texts[getIndex(x, y)] = m_textIds->value(text, -1);
+    }
+}
+
+void RunReplay::StateMouse::clearText(int x, int y) {
+    if (isWithinMaze(x, y)) {
+        m_state->texts[getIndex(x, y)] = -1;
+    }
+}
+
+void RunReplay::StateMouse::clearAllText() {
+    m_state->texts.fill(-1);
+}
+
+bool RunReplay::StateMouse::wasReset() {
+    return false;
+}
+
+void RunReplay::StateMouse::ackReset() {
+    m_state->x = 0;
+    m_state->y = 0;
+    m_state->direction = Direction::NORTH;
+}
+
+bool RunReplay::StateMouse::isWithinMaze(int x, int y) const {
+    return
+        0 <= x && x < m_maze->getWidth() &&
+        0 <= y && y < m_maze->getHeight();
+}
+
+int RunReplay::StateMouse::getIndex(int x, int y) const {
+    return m_maze->getHeight() * x + y;
+}
+
+void RunReplay::StateMouse::updateWall(
+        int x,
+        int y,
+        QChar direction,
+        bool isSet) {
+    if (!isWithinMaze(x, y) || !CHAR_TO_DIRECTION().contains(direction)) {
+        return;
+    }
+
+    // Walls are shared with the neighboring tile, if any
+    static const int dx[] = {0, 1, 0, -1};
+    static const int dy[] = {1, 0, -1, 0};
+    int d = static_cast<int>(CHAR_TO_DIRECTION().value(direction));
+    quint8 bit = 1 << d;
+    quint8 opposingBit = 1 << ((d + 2) % 4);
+    int index = getIndex(x, y);
+    m_state->walls[index] = isSet ?
+        m_state->walls.at(index) | bit :
+        m_state->walls.at(index) & ~bit;
+    int nx = x + dx[d];
+    int ny = y + dy[d];
+    if (isWithinMaze(nx, ny)) {
+        int neighbor = getIndex(nx, ny);
+        m_state->walls[neighbor] = isSet ?
+            m_state->walls.at(neighbor) | opposingBit :
+            m_state->walls.at(neighbor) & ~opposingBit;
+    }
+}
+
+bool RunReplay::readVarint(
+        const QByteArray& bytes,
+        int* offset,
+        quint64* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (bytes.size() <= *offset) {
+            return false;
+        }
+        quint8 byte = static_cast<quint8>(bytes.at(*offset));
+        *offset += 1;
+        *value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RunReplay::readString(
+        const QByteArray& bytes,
+        int* offset,
+        QString* value) {
+    quint64 length = 0;
+    if (
+        !readVarint(bytes, offset, &length) ||
+        static_cast<quint64>(bytes.size() - *offset) < length
+    ) {
+        return false;
+    }
+    *value = QString::fromUtf8(bytes.constData() + *offset, length);
+    *offset += length;
+    return true;
+}
+
+qint64 RunReplay::unzigzag(quint64 value) {
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+}
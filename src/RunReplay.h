@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QByteArray>
+#include <QChar>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "CommandDispatcher.h"
+#include "CommandParser.h"
+#include "Direction.h"
+#include "Maze.h"
+#include "MazeGraphic.h"
+#include "Mouse.h"
+
+namespace mms {
+
+// Plays back a recording made by the RunRecorder onto a MazeGraphic and a
+// Mouse, without the algorithm. The commands are performed by the
+// CommandDispatcher, like those of a run, on a compact copy of the tile and
+// mouse state, which is snapshotted every KEYFRAME_INTERVAL
+// commands when the recording is loaded, so that seeking anywhere just
+// restores the preceding keyframe and applies the commands after it. Only
+// the tiles that differ from what's shown are then updated.
+class RunReplay {
+
+public:
+
+    // Plays back as fast as the recorded commands can be shown, regardless of
+    // their timestamps
+    static const double MAX_SPEED;
+
+    // Returns nullptr if the file isn't a valid recording, or if it was
+    // recorded in a maze of a different size
+    static RunReplay* fromFile(const QString& path, const Maze* maze);
+
+    QString getMazeFile() const;
+    int getNumCommands() const;
+
+    // The number of commands that have been played back
+    int getPosition() const;
+    bool isFinished() const;
+
+    // Shows the replay on the graphic, which must be of a new MazeView, and
+    // the mouse; must be called before seeking or advancing
+    void attach(MazeGraphic* graphic, Mouse* mouse);
+
+    // Shows the state after the given number of commands
+    void seek(int position);
+
+    // Plays back the commands recorded within the given number of seconds,
+    // scaled by the speed
+    void advance(double seconds, double speed);
+
+private:
+
+    static const int KEYFRAME_INTERVAL;
+    static const double MAX_SPEED_COMMANDS_PER_SECOND;
+
+    // Everything that the commands can change, where tiles are indexed as in
+    // the WallGrid; colors and texts are -1 if the tile has none
+    struct State {
+        QVector<quint8> walls;
+        QVector<int> colors;
+        QVector<int> texts;
+        int x;
+        int y;
+        Direction direction;
+        // Whether the mouse is on its wheels, which aren't simulated, so that
+        // it no longer moves a tile at a time, as in a run
+        bool isOnWheels;
+    };
+
+    // Performs commands on a State, as the Window does on a run, except that
+    // movements are instantaneous; texts are stored by their string ids
+    class StateMouse : public MouseInterface {
+    public:
+        StateMouse(
+            const Maze* maze,
+            const QHash<QString, int>* textIds,
+            State* state);
+        int mazeWidth() override;
+        int mazeHeight() override;
+        bool wallFront() override;
+        bool wallRight() override;
+        bool wallLeft() override;
+        QString moveForward() override;
+        QString turnRight() override;
+        QString turnLeft() override;
+        void setWheelSpeeds(int left, int right) override;
+        QPair<int, int> readEncoders() override;
+        QVector<double> readSensors() override;
+        void setWall(int x, int y, QChar direction) override;
+        void clearWall(int x, int y, QChar direction) override;
+        void setColor(int x, int y, QChar color) override;
+        void clearColor(int x, int y) override;
+        void clearAllColor() override;
+        void setText(int x, int y, const QString& text) override;
+        void clearText(int x, int y) override;
+        void clearAllText() override;
+        bool wasReset() override;
+        void ackReset() override;
+    private:
+        const Maze* m_maze;
+        const QHash<QString, int>* m_textIds;
+        State* m_state;
+        bool isWithinMaze(int x, int y) const;
+        int getIndex(int x, int y) const;
+        void updateWall(int x, int y, QChar direction, bool isSet);
+    };
+
+    RunReplay(const Maze* maze);
+
+    const Maze* m_maze;
+    QString m_mazeFile;
+    QStringList m_strings;
+    QHash<QString, int> m_textIds;
+
+    // The recorded commands, and when each of them arrived, in nanoseconds
+    // since the first command
+    QVector<Command> m_commands;
+    QVector<qint64> m_timestamps;
+
+    // The state before every KEYFRAME_INTERVAL-th command, and at the end of
+    // the recording if it falls on one
+    QVector<State> m_keyframes;
+
+    // The state after the first m_position commands, and the recording time
+    // that has been played back, in nanoseconds since the first command
+    State m_state;
+    int m_position;
+    qint64 m_time;
+    double m_maxSpeedCommands;
+
+    // What the graphic and mouse currently show
+    MazeGraphic* m_graphic;
+    Mouse* m_mouse;
+    State m_shown;
+
+    bool load(const QByteArray& bytes);
+    State getInitialState() const;
+    void apply(const Command& command, State* state) const;
+    void moveTo(int position);
+    void show();
+
+    static bool readVarint(const QByteArray& bytes, int* offset, quint64* value);
+    static bool readString(const QByteArray& bytes, int* offset, QString* value);
+    static qint64 unzigzag(quint64 value);
+};
+
+}
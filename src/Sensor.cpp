@@ -0,0 +1,58 @@
+#include "Sensor.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+
+namespace mms {
+
+const int Sensor::NUM_EDGE_POINTS = 5;
+
+Sensor::Sensor(
+        const Distance& range,
+        const Angle& halfWidth,
+        const Coordinate& position,
+        const Angle& direction) :
+    m_range(range.getMeters()),
+    m_halfWidth(halfWidth.getRadiansUnbounded()),
+    m_forward(position.getX().getMeters()),
+    m_left(position.getY().getMeters()),
+    m_direction(direction.getRadiansUnbounded()) {
+}
+
+void Sensor::appendRays(
+        double mouseX,
+        double mouseY,
+        double mouseRotation,
+        QVector<RayCaster::Ray>* rays) const {
+    double cos = std::cos(mouseRotation);
+    double sin = std::sin(mouseRotation);
+    double x = mouseX + m_forward * cos - m_left * sin;
+    double y = mouseY + m_forward * sin + m_left * cos;
+    double direction = mouseRotation + m_direction;
+    for (int i = 0; i < NUM_EDGE_POINTS; i += 1) {
+        double fraction = 2.0 * i / (NUM_EDGE_POINTS - 1) - 1.0;
+        double angle = direction + m_halfWidth * fraction;
+        rays->append({
+            x,
+            y,
+            std::cos(angle),
+            std::sin(angle),
+            m_range,
+        });
+    }
+}
+
+double Sensor::read(const double* distances) const {
+    // The rays are evenly spaced, so the area of each triangle of the fan is
+    // proportional to the product of the lengths of its sides, and the angle
+    // between them cancels out
+    double area = 0.0;
+    for (int i = 1; i < NUM_EDGE_POINTS; i += 1) {
+        area += distances[i - 1] * distances[i];
+    }
+    double viewArea = (NUM_EDGE_POINTS - 1) * m_range * m_range;
+    return qBound(0.0, 1.0 - area / viewArea, 1.0);
+}
+
+}
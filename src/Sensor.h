@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QVector>
+
+#include "units/Angle.h"
+#include "units/Coordinate.h"
+#include "units/Distance.h"
+
+#include "RayCaster.h"
+
+namespace mms {
+
+// A distance sensor of the continuously simulated mouse. Its view is a fan of
+// rays; the reading is the fraction of the area of the fan that's blocked by
+// walls, from 0.0 (nothing in range) to 1.0 (a wall right in front of it).
+class Sensor {
+
+public:
+
+    // The number of rays in the fan
+    static const int NUM_EDGE_POINTS;
+
+    // The position and direction are relative to the center of the mouse,
+    // with the mouse facing along the x axis
+    Sensor(
+        const Distance& range,
+        const Angle& halfWidth,
+        const Coordinate& position,
+        const Angle& direction);
+
+    // Appends the NUM_EDGE_POINTS rays of the fan, so that the rays of many
+    // sensors can be cast at once, given the pose of the mouse in meters and
+    // radians
+    void appendRays(
+        double mouseX,
+        double mouseY,
+        double mouseRotation,
+        QVector<RayCaster::Ray>* rays) const;
+
+    // The reading, given the distances of the rays of the fan
+    double read(const double* distances) const;
+
+private:
+
+    double m_range;
+    double m_halfWidth;
+    double m_forward;
+    double m_left;
+    double m_direction;
+
+};
+
+}
@@ -8,6 +8,7 @@
 namespace mms {
 
 Settings* Settings::INSTANCE = nullptr;
+const int Settings::FLUSH_DELAY_MILLISECONDS = 1000;
 
 void Settings::init() {
     ASSERT_TR(INSTANCE == nullptr);
@@ -19,21 +20,61 @@ Settings* Settings::get() {
     return INSTANCE;
 }
 
-QString Settings::value(QString group, QString key) {
+void Settings::flush() {
+
+    if (m_dirtyGroups.isEmpty()) {
+        return;
+    }
+    m_flushTimer->stop();
+
+    // Keys of non-array groups are never removed, so they're just written
+    // over. Arrays may shrink, so they're removed and written anew.
     QSettings settings;
-    settings.beginGroup(group);
-    return settings.value(key).toString();
+    for (const QString& group : m_dirtyGroups) {
+        if (m_groups.contains(group)) {
+            settings.beginGroup(group);
+            const QMap<QString, QString>& values = m_groups[group];
+            QMap<QString, QString>::const_iterator it;
+            for (it = values.constBegin(); it != values.constEnd(); it += 1) {
+                settings.setValue(it.key(), it.value());
+            }
+            settings.endGroup();
+        }
+        if (m_arrayGroups.contains(group)) {
+            const QVector<QMap<QString, QString>>& entries = m_arrayGroups[group];
+            settings.remove(group);
+            settings.beginWriteArray(group, entries.size());
+            for (int i = 0; i < entries.size(); i += 1) {
+                settings.setArrayIndex(i);
+                const QMap<QString, QString>& entry = entries.at(i);
+                QMap<QString, QString>::const_iterator it;
+                for (it = entry.constBegin(); it != entry.constEnd(); it += 1) {
+                    settings.setValue(it.key(), it.value());
+                }
+            }
+            settings.endArray();
+        }
+    }
+    settings.sync();
+    m_dirtyGroups.clear();
+}
+
+QString Settings::value(QString group, QString key) {
+    return m_groups.value(group).value(key);
 }
 
 void Settings::update(QString group, QString key, QString value) {
-    QSettings settings;
-    settings.beginGroup(group);
-    settings.setValue(key, value);
+    QMap<QString, QString>& entries = m_groups[group];
+    if (entries.contains(key) && entries.value(key) == value) {
+        return;
+    }
+    entries[key] = value;
+    scheduleFlush(group);
 }
 
 QStringList Settings::values(QString group, QString key) {
     QStringList values;
-    for (const auto& entry : getGroup(group)) {
+    for (const auto& entry : m_arrayGroups.value(group)) {
         values << entry.value(key);
     }
     values.sort(Qt::CaseInsensitive);
@@ -46,19 +87,8 @@ void Settings::add(QString group, QMap<QString, QString> entry) {
     ASSERT_FA(group.isEmpty());
     ASSERT_FA(entry.isEmpty());
 
-    // Get the current size
-    QSettings settings;
-    int size = settings.beginReadArray(group);
-    settings.endArray();
-
-    // Append the element at the current size
-    settings.beginWriteArray(group);
-    settings.setArrayIndex(size);
-    QMap<QString, QString>::const_iterator it;
-    for (it = entry.constBegin(); it != entry.constEnd(); it += 1) {
-        settings.setValue(it.key(), it.value());
-    }
-    settings.endArray();
+    m_arrayGroups[group].append(entry);
+    scheduleFlush(group);
 }
 
 void Settings::remove(QString group, QString key, QString value) {
@@ -67,27 +97,15 @@ void Settings::remove(QString group, QString key, QString value) {
     ASSERT_FA(group.isEmpty());
     ASSERT_FA(key.isEmpty());
 
-    // Get all existing entries
-    QVector<QMap<QString, QString>> entries = getGroup(group);
-
-    // Remove all existing entries
-    QSettings settings;
-    settings.remove(group);
-
-    // Write back entries that don't have value given
-    settings.beginWriteArray(group);
-    int index = 0;
-    for (const auto& entry : entries) {
+    // Keep the entries that don't have the given value
+    QVector<QMap<QString, QString>> entries;
+    for (const auto& entry : m_arrayGroups.value(group)) {
         if (entry.value(key) != value) {
-            settings.setArrayIndex(index);
-            QMap<QString, QString>::const_iterator it;
-            for (it = entry.constBegin(); it != entry.constEnd(); it += 1) {
-                settings.setValue(it.key(), it.value());
-            }
-            index += 1;
+            entries.append(entry);
         }
     }
-    settings.endArray();
+    m_arrayGroups[group] = entries;
+    scheduleFlush(group);
 }
 
 QVector<QMap<QString, QString>> Settings::find(
@@ -101,7 +119,7 @@ QVector<QMap<QString, QString>> Settings::find(
 
     // Find entries that match the criteria
     QVector<QMap<QString, QString>> entries;
-    for (const auto& entry : getGroup(group)) {
+    for (const auto& entry : m_arrayGroups.value(group)) {
         if (entry.value(key) == value) {
             entries.append(entry);
         }
@@ -119,47 +137,85 @@ void Settings::update(
     ASSERT_FA(group.isEmpty());
     ASSERT_FA(key.isEmpty());
 
-    // Find the entries to update
-    QVector<QMap<QString, QString>> entries = find(group, key, value);
-
-    // Remove those entries
-    remove(group, key, value);
-
-    // Re-add the entries, but with updates
-    for (QMap<QString, QString> entry : entries) {
+    // Update the matching entries in place
+    QVector<QMap<QString, QString>>& entries = m_arrayGroups[group];
+    for (int i = 0; i < entries.size(); i += 1) {
+        if (entries.at(i).value(key) != value) {
+            continue;
+        }
         QMap<QString, QString>::const_iterator it;
         for (it = changes.constBegin(); it != changes.constEnd(); it += 1) {
-            entry[it.key()] = it.value();
+            entries[i][it.key()] = it.value();
         }
-        add(group, entry);
     }
+    scheduleFlush(group);
 }
 
-Settings::Settings() {
+Settings::Settings() :
+    m_flushTimer(new QTimer()) {
+
     QCoreApplication::setOrganizationName("mackorone");
     QCoreApplication::setOrganizationDomain("www.github.com/mackorone");
     QCoreApplication::setApplicationName("mms");
-}
 
-QVector<QMap<QString, QString>> Settings::getGroup(QString group) {
+    // Restarting the timer on every change postpones the write until the
+    // changes stop coming
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_DELAY_MILLISECONDS);
+    QObject::connect(m_flushTimer, &QTimer::timeout, [this](){
+        flush();
+    });
 
-    // Group must be nonempty
-    ASSERT_FA(group.isEmpty());
+    load();
+}
 
-    // Get all entries for a given group
-    QVector<QMap<QString, QString>> entries;
+void Settings::load() {
+
+    // This is the only time that the settings are read from disk
     QSettings settings;
-    int size = settings.beginReadArray(group);
-    for (int i = 0; i < size; i += 1) {
-        settings.setArrayIndex(i);
-        QMap<QString, QString> map;
-        for (QString key : settings.allKeys()) {
-            map[key] = settings.value(key).toString();
+    for (QString group : settings.childGroups()) {
+
+        // Array groups are the ones with a size, whose subgroups are exactly
+        // the indices of the entries (which start at one), and nothing else
+        settings.beginGroup(group);
+        bool isArrayGroup = settings.childKeys() == QStringList("size");
+        int size = settings.value("size").toInt();
+        for (const QString& index : settings.childGroups()) {
+            bool isInt = false;
+            int value = index.toInt(&isInt);
+            if (!isInt || value < 1 || size < value) {
+                isArrayGroup = false;
+            }
+        }
+        settings.endGroup();
+
+        if (isArrayGroup) {
+            QVector<QMap<QString, QString>>& entries = m_arrayGroups[group];
+            size = settings.beginReadArray(group);
+            for (int i = 0; i < size; i += 1) {
+                settings.setArrayIndex(i);
+                QMap<QString, QString> map;
+                for (QString key : settings.allKeys()) {
+                    map[key] = settings.value(key).toString();
+                }
+                entries.append(map);
+            }
+            settings.endArray();
+        }
+        else {
+            QMap<QString, QString>& values = m_groups[group];
+            settings.beginGroup(group);
+            for (QString key : settings.childKeys()) {
+                values[key] = settings.value(key).toString();
+            }
+            settings.endGroup();
         }
-        entries.append(map);
     }
-    settings.endArray();
-    return entries;
+}
+
+void Settings::scheduleFlush(const QString& group) {
+    m_dirtyGroups.insert(group);
+    m_flushTimer->start();
 }
 
 } 
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <QMap>
+#include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QTimer>
 #include <QVector>
 
 namespace mms {
 
+// All settings are read from disk once, when the singleton is initialized,
+// and are then served from memory. Changes are written back to disk shortly
+// after they're made (a burst of changes results in a single write), and when
+// the application exits.
 class Settings {
 
 public:
@@ -14,6 +20,9 @@ public:
     static void init();
     static Settings* get();
 
+    // Writes any pending changes to disk immediately
+    void flush();
+
     // --- Non-array Functions --- //
 
     QString value(QString group, QString key);
@@ -48,8 +57,23 @@ private:
     Settings();
     static Settings* INSTANCE;
 
-    // Returns all entries for a given group
-    QVector<QMap<QString, QString>> getGroup(QString group);
+    // How long after the most recent change to write the settings to disk
+    static const int FLUSH_DELAY_MILLISECONDS;
+
+    // The non-array groups, mapping keys to values
+    QMap<QString, QMap<QString, QString>> m_groups;
+
+    // The array groups, each a list of entries
+    QMap<QString, QVector<QMap<QString, QString>>> m_arrayGroups;
+
+    // The groups with changes that haven't been written to disk yet; only
+    // these are written, so that whatever else is on disk (e.g., settings of
+    // other versions) is left alone
+    QSet<QString> m_dirtyGroups;
+    QTimer* m_flushTimer;
+
+    void load();
+    void scheduleFlush(const QString& group);
 
 };
 
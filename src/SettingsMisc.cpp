@@ -10,6 +10,7 @@ const QString SettingsMisc::KEY_RECENT_MAZE_ALGO = "recent-maze-file";
 const QString SettingsMisc::KEY_RECENT_MOUSE_ALGO = "recent-mouse-algo";
 const QString SettingsMisc::KEY_RECENT_WINDOW_WIDTH = "recent-window-width";
 const QString SettingsMisc::KEY_RECENT_WINDOW_HEIGHT = "recent-window-height";
+const QString SettingsMisc::KEY_RUN_LOG_TO_FILE = "run-log-to-file";
 
 QString SettingsMisc::getRecentMazeFile() {
     return getValue(KEY_RECENT_MAZE_ALGO);
@@ -43,6 +44,14 @@ void SettingsMisc::setRecentWindowHeight(int height) {
     setValue(KEY_RECENT_WINDOW_HEIGHT, QString::number(height));
 }
 
+bool SettingsMisc::getRunLogToFile() {
+    return getValue(KEY_RUN_LOG_TO_FILE) == "true";
+}
+
+void SettingsMisc::setRunLogToFile(bool enabled) {
+    setValue(KEY_RUN_LOG_TO_FILE, enabled ? "true" : "false");
+}
+
 int SettingsMisc::getNumber(QString key, int defaultValue) {
     bool ok = true;
     int number = getValue(key).toInt(&ok);
@@ -22,6 +22,9 @@ public:
     static int getRecentWindowHeight();
     static void setRecentWindowHeight(int height);
 
+    static bool getRunLogToFile();
+    static void setRunLogToFile(bool enabled);
+
 private:
 
     static const QString GROUP;
@@ -29,6 +32,7 @@ private:
     static const QString KEY_RECENT_MOUSE_ALGO;
     static const QString KEY_RECENT_WINDOW_WIDTH;
     static const QString KEY_RECENT_WINDOW_HEIGHT;
+    static const QString KEY_RUN_LOG_TO_FILE;
 
     static int getNumber(QString key, int defaultValue);
     static QString getValue(const QString& key);
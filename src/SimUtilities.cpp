@@ -10,14 +10,13 @@ double SimUtilities::getHighResTimestamp() {
     return QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0;
 }
 
-QVector<TriangleGraphic> SimUtilities::polygonToTriangleGraphics(
+void SimUtilities::polygonToTriangleGraphics(
         const Polygon& polygon,
         Color color,
-        unsigned char alpha) {
-    QVector<Triangle> triangles = polygon.getTriangles();
-    QVector<TriangleGraphic> triangleGraphics;
+        unsigned char alpha,
+        QVector<TriangleGraphic>* output) {
     RGB colorValues = COLOR_TO_RGB().value(color);
-    for (Triangle triangle : triangles) {
+    for (const Triangle& triangle : polygon.getTriangles()) {
         TriangleGraphic graphic;
         graphic.p1 = {
             static_cast<float>(triangle.p1.getX().getMeters()),
@@ -37,9 +36,8 @@ QVector<TriangleGraphic> SimUtilities::polygonToTriangleGraphics(
             colorValues,
             alpha,
         };
-        triangleGraphics.append(graphic);
+        output->append(graphic);
     }
-    return triangleGraphics;
 }
 
 } 
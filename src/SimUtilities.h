@@ -20,11 +20,12 @@ public:
     // Like time() in <ctime> but higher resolution (returns seconds since epoch)
     static double getHighResTimestamp();
 
-    // Converts a polygon to a vector of triangle graphics
-    static QVector<TriangleGraphic> polygonToTriangleGraphics(
+    // Converts a polygon to triangle graphics, appending them to the output
+    static void polygonToTriangleGraphics(
         const Polygon& polygon,
         Color color,
-        unsigned char alpha);
+        unsigned char alpha,
+        QVector<TriangleGraphic>* output);
 
 };
 
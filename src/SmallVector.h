@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QVector>
+
+#include "AssertMacros.h"
+
+namespace mms {
+
+// A vector that stores up to N elements inline, without any heap allocations,
+// and only falls back to a QVector once it grows beyond that. Copying and
+// moving are as cheap as copying N elements. The element type must be default
+// constructible, and elements past the size are left in an unspecified state.
+template <typename T, int N>
+class SmallVector {
+
+public:
+
+    SmallVector() :
+        m_size(0),
+        m_isInline(true) {
+    }
+
+    int size() const {
+        return m_size;
+    }
+
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+
+    const T& at(int i) const {
+        ASSERT_LE(0, i);
+        ASSERT_LT(i, m_size);
+        return data()[i];
+    }
+
+    T& operator[](int i) {
+        return data()[i];
+    }
+
+    const T& operator[](int i) const {
+        return data()[i];
+    }
+
+    const T* data() const {
+        return m_isInline ? m_inline : m_overflow.constData();
+    }
+
+    T* data() {
+        return m_isInline ? m_inline : m_overflow.data();
+    }
+
+    const T* begin() const {
+        return data();
+    }
+
+    const T* end() const {
+        return data() + m_size;
+    }
+
+    void clear() {
+        // Keep using the overflow storage, if any, so that we don't allocate
+        // again the next time the vector is filled up
+        m_size = 0;
+    }
+
+    void resize(int size) {
+        ASSERT_LE(0, size);
+        if (m_isInline && N < size) {
+            m_overflow.resize(size);
+            for (int i = 0; i < m_size; i += 1) {
+                m_overflow[i] = m_inline[i];
+            }
+            m_isInline = false;
+        }
+        else if (!m_isInline && m_overflow.size() < size) {
+            m_overflow.resize(size);
+        }
+        m_size = size;
+    }
+
+    void append(const T& value) {
+        resize(m_size + 1);
+        data()[m_size - 1] = value;
+    }
+
+    QVector<T> toVector() const {
+        QVector<T> vector;
+        vector.reserve(m_size);
+        for (int i = 0; i < m_size; i += 1) {
+            vector.append(data()[i]);
+        }
+        return vector;
+    }
+
+private:
+
+    int m_size;
+    bool m_isInline;
+    T m_inline[N];
+    QVector<T> m_overflow;
+
+};
+
+} 
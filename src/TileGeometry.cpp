@@ -0,0 +1,99 @@
+#include "TileGeometry.h"
+
+#include "AssertMacros.h"
+#include "Dimensions.h"
+
+namespace mms {
+
+QPair<Coordinate, Coordinate> TileGeometry::getFullRectangle(
+        int x, int y, int mazeWidth, int mazeHeight) {
+    Distance halfWallWidth = Dimensions::halfWallWidth();
+    Distance tileLength = Dimensions::tileLength();
+    Coordinate lowerLeft = Coordinate::Cartesian(
+        tileLength * x - halfWallWidth * (x == 0 ? 1 : 0),
+        tileLength * y - halfWallWidth * (y == 0 ? 1 : 0)
+    );
+    Coordinate upperRight = Coordinate::Cartesian(
+        tileLength * (x + 1) + halfWallWidth * (x == mazeWidth - 1 ? 1 : 0),
+        tileLength * (y + 1) + halfWallWidth * (y == mazeHeight - 1 ? 1 : 0)
+    );
+    return {lowerLeft, upperRight};
+}
+
+QPair<Coordinate, Coordinate> TileGeometry::getInteriorRectangle(
+        int x, int y, int mazeWidth, int mazeHeight) {
+    Distance halfWallWidth = Dimensions::halfWallWidth();
+    QPair<Coordinate, Coordinate> full =
+        getFullRectangle(x, y, mazeWidth, mazeHeight);
+    Coordinate lowerLeft = full.first + Coordinate::Cartesian(
+        halfWallWidth * (x == 0 ? 2 : 1),
+        halfWallWidth * (y == 0 ? 2 : 1)
+    );
+    Coordinate upperRight = full.second - Coordinate::Cartesian(
+        halfWallWidth * (x == mazeWidth - 1 ? 2 : 1),
+        halfWallWidth * (y == mazeHeight - 1 ? 2 : 1)
+    );
+    return {lowerLeft, upperRight};
+}
+
+QPair<Coordinate, Coordinate> TileGeometry::getWallRectangle(
+        int x, int y, int mazeWidth, int mazeHeight, Direction direction) {
+
+    QPair<Coordinate, Coordinate> outer =
+        getFullRectangle(x, y, mazeWidth, mazeHeight);
+    QPair<Coordinate, Coordinate> inner =
+        getInteriorRectangle(x, y, mazeWidth, mazeHeight);
+
+    switch (direction) {
+        case Direction::NORTH:
+            return {
+                Coordinate::Cartesian(inner.first.getX(), inner.second.getY()),
+                Coordinate::Cartesian(inner.second.getX(), outer.second.getY()),
+            };
+        case Direction::EAST:
+            return {
+                Coordinate::Cartesian(inner.second.getX(), inner.first.getY()),
+                Coordinate::Cartesian(outer.second.getX(), inner.second.getY()),
+            };
+        case Direction::SOUTH:
+            return {
+                Coordinate::Cartesian(inner.first.getX(), outer.first.getY()),
+                Coordinate::Cartesian(inner.second.getX(), inner.first.getY()),
+            };
+        case Direction::WEST:
+            return {
+                Coordinate::Cartesian(outer.first.getX(), inner.first.getY()),
+                Coordinate::Cartesian(inner.first.getX(), inner.second.getY()),
+            };
+    }
+    ASSERT_NEVER_RUNS();
+}
+
+QPair<Coordinate, Coordinate> TileGeometry::getCornerRectangle(
+        int x, int y, int mazeWidth, int mazeHeight, int cornerNumber) {
+
+    QPair<Coordinate, Coordinate> outer =
+        getFullRectangle(x, y, mazeWidth, mazeHeight);
+    QPair<Coordinate, Coordinate> inner =
+        getInteriorRectangle(x, y, mazeWidth, mazeHeight);
+
+    switch (cornerNumber) {
+        case 0:
+            return {outer.first, inner.first};
+        case 1:
+            return {
+                Coordinate::Cartesian(outer.first.getX(), inner.second.getY()),
+                Coordinate::Cartesian(inner.first.getX(), outer.second.getY()),
+            };
+        case 2:
+            return {inner.second, outer.second};
+        case 3:
+            return {
+                Coordinate::Cartesian(inner.second.getX(), outer.first.getY()),
+                Coordinate::Cartesian(outer.second.getX(), inner.first.getY()),
+            };
+    }
+    ASSERT_NEVER_RUNS();
+}
+
+} 
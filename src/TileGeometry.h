@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QPair>
+
+#include "Direction.h"
+#include "units/Coordinate.h"
+
+namespace mms {
+
+class TileGeometry {
+
+public:
+
+    // The TileGeometry class is not constructible
+    TileGeometry() = delete;
+
+    // Every shape that makes up a tile is an axis-aligned rectangle, so
+    // rather than storing polygons for every tile we compute the lower left
+    // and upper right corners of each rectangle from the tile's position:
+    //
+    //      full: 05af
+    //
+    //      interior: 278d
+    //
+    //      northWall: 7698
+    //      eastWall: d8be
+    //      southWall: 32dc
+    //      westWall: 1472
+    //
+    //      lowerLeftCorner: 0123
+    //      upperLeftCorner: 4567
+    //      upperRightCorner: 89ab
+    //      lowerRightCorner: cdef
+    //
+    //      5---6-------------9---a
+    //      |   |             |   |
+    //      4---7-------------8---b
+    //      |   |             |   |
+    //      |   |             |   |
+    //      |   |             |   |
+    //      |   |             |   |
+    //      |   |             |   |
+    //      1---2-------------d---e
+    //      |   |             |   |
+    //      0---3-------------c---f
+    //
+    // Tiles on the edge of the maze extend by half of a wall width, so that
+    // the perimeter walls are as thick as the interior walls.
+
+    static QPair<Coordinate, Coordinate> getFullRectangle(
+        int x, int y, int mazeWidth, int mazeHeight);
+
+    static QPair<Coordinate, Coordinate> getInteriorRectangle(
+        int x, int y, int mazeWidth, int mazeHeight);
+
+    static QPair<Coordinate, Coordinate> getWallRectangle(
+        int x, int y, int mazeWidth, int mazeHeight, Direction direction);
+
+    // Corners are numbered clockwise, starting from the lower left
+    static QPair<Coordinate, Coordinate> getCornerRectangle(
+        int x, int y, int mazeWidth, int mazeHeight, int cornerNumber);
+
+};
+
+} 
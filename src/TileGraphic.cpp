@@ -5,7 +5,7 @@
 #include "AssertMacros.h"
 #include "Color.h"
 #include "ColorManager.h"
-#include "FontImage.h"
+#include "TileGeometry.h"
 
 namespace mms {
 
@@ -14,41 +14,62 @@ TileGraphic::TileGraphic() {
 }
 
 TileGraphic::TileGraphic(
-    const Tile* tile,
+    const Maze* maze,
+    int x,
+    int y,
     BufferInterface* bufferInterface) :
-    m_tile(tile),
+    m_maze(maze),
+    m_x(x),
+    m_y(y),
     m_bufferInterface(bufferInterface),
-    m_color(ColorManager::getTileBaseColor()) {
+    m_color(ColorManager::getTileBaseColor()),
+    m_flushedColor(m_color) {
+    for (Direction direction : DIRECTIONS()) {
+        m_flushedWallAlphas[static_cast<int>(direction)] =
+            getWallAlpha(direction);
+    }
 }
 
 void TileGraphic::setWall(Direction direction) {
     m_walls[direction] = true;
-    updateWall(direction);
 }
 
 void TileGraphic::clearWall(Direction direction) {
     m_walls.remove(direction);
-    updateWall(direction);
 }
 
 void TileGraphic::setColor(Color color) {
     m_color = color;
-    updateColor();
 }
 
 void TileGraphic::clearColor() {
     m_color = ColorManager::getTileBaseColor();
-    updateColor();
 }
 
 void TileGraphic::setText(const QString& text) {
     m_text = text;
-    updateText();
 }
 
 void TileGraphic::clearText() {
     m_text = "";
-    updateText();
+}
+
+void TileGraphic::flush() {
+    for (Direction direction : DIRECTIONS()) {
+        unsigned char alpha = getWallAlpha(direction);
+        if (alpha != m_flushedWallAlphas[static_cast<int>(direction)]) {
+            updateWall(direction);
+            m_flushedWallAlphas[static_cast<int>(direction)] = alpha;
+        }
+    }
+    if (m_color != m_flushedColor) {
+        updateColor();
+        m_flushedColor = m_color;
+    }
+    if (m_text != m_flushedText) {
+        updateText();
+        m_flushedText = m_text;
+    }
 }
 
 void TileGraphic::drawPolygons() const {
@@ -57,22 +78,28 @@ void TileGraphic::drawPolygons() const {
     // determines the order in which the polygons are drawn. Also note that the
     // *StartingIndex methods in GrahicsUtilities.h depend upon this order.
 
+    // The geometry isn't stored anywhere, it's computed from the position
+    int width = m_maze->getWidth();
+    int height = m_maze->getHeight();
+
     // Draw the base of the tile
     m_bufferInterface->insertIntoGraphicCpuBuffer(
-        m_tile->getFullPolygon(), m_color, 255);
+        TileGeometry::getFullRectangle(m_x, m_y, width, height),
+        m_color,
+        255);
 
     // Draw each of the walls of the tile
     for (Direction direction : DIRECTIONS()) {
         m_bufferInterface->insertIntoGraphicCpuBuffer(
-            m_tile->getWallPolygon(direction),
+            TileGeometry::getWallRectangle(m_x, m_y, width, height, direction),
             ColorManager::getTileWallColor(),
             getWallAlpha(direction));
     }
 
     // Draw the corners of the tile
-    for (Polygon polygon : m_tile->getCornerPolygons()) {
+    for (int cornerNumber = 0; cornerNumber < 4; cornerNumber += 1) {
         m_bufferInterface->insertIntoGraphicCpuBuffer(
-            polygon,
+            TileGeometry::getCornerRectangle(m_x, m_y, width, height, cornerNumber),
             ColorManager::getTileCornerColor(),
             255);
     }
@@ -89,12 +116,13 @@ void TileGraphic::drawTextures() {
     }
     // ... and then populate those triangle texture objects with data
     updateText();
+    m_flushedText = m_text;
 }
 
 void TileGraphic::updateWall(Direction direction) const {
     m_bufferInterface->updateTileGraphicWallColor(
-        m_tile->getX(),
-        m_tile->getY(),
+        m_x,
+        m_y,
         direction,
         ColorManager::getTileWallColor(),
         getWallAlpha(direction)
@@ -104,66 +132,20 @@ void TileGraphic::updateWall(Direction direction) const {
 
 void TileGraphic::updateColor() const {
     m_bufferInterface->updateTileGraphicBaseColor(
-        m_tile->getX(),
-        m_tile->getY(),
+        m_x,
+        m_y,
         m_color);
 }
 
 void TileGraphic::updateText() const {
-
-    // First, retrieve the maximum number of rows and cols of text allowed
-    QPair<int, int> maxRowsAndCols =
-        m_bufferInterface->getTileGraphicTextMaxSize();
-
-    // Then, generate the rows of text that will be displayed
-    QStringList rowsOfText;
-
-    // Split the text into rows
-    QString remaining = m_text;
-    while (!remaining.isEmpty() && rowsOfText.size() < maxRowsAndCols.first) {
-        QString row = remaining.left(maxRowsAndCols.second);
-        rowsOfText.append(row);
-        remaining = remaining.mid(maxRowsAndCols.second);
-    }
-
-    // For all possible character positions, insert some character
-    // (blank if necessary) into the tile text cpu buffer
-    for (int row = 0; row < maxRowsAndCols.first; row += 1) {
-        for (int col = 0; col < maxRowsAndCols.second; col += 1) {
-            int numRows = std::min(
-                static_cast<int>(rowsOfText.size()),
-                maxRowsAndCols.first
-            );
-            int numCols = std::min(
-                static_cast<int>(row < rowsOfText.size() ? rowsOfText.at(row).size() : 0),
-                maxRowsAndCols.second
-            );
-            QChar c = ' ';
-            if (
-                row < rowsOfText.size() &&
-                col < rowsOfText.at(row).size()
-            ) {
-                c = rowsOfText.at(row).at(col);
-            }
-            ASSERT_TR(FontImage::positions().contains(c));
-            m_bufferInterface->updateTileGraphicText(
-                m_tile->getX(),
-                m_tile->getY(),
-                numRows,
-                numCols,
-                row,
-                col,
-                c
-            );
-        }
-    }
+    m_bufferInterface->updateTileGraphicText(m_x, m_y, m_text);
 }
 
 unsigned char TileGraphic::getWallAlpha(Direction direction) const {
     if (m_walls.value(direction)) {
         return 255;
     }
-    if (m_tile->isWall(direction)) {
+    if (m_maze->isWall(m_x, m_y, direction)) {
         return 64;
     }
     return 0;
@@ -5,7 +5,7 @@
 
 #include "BufferInterface.h"
 #include "Color.h"
-#include "Tile.h"
+#include "Maze.h"
 
 namespace mms {
 
@@ -15,7 +15,9 @@ public:
 
     TileGraphic();
     TileGraphic(
-        const Tile* tile,
+        const Maze* maze,
+        int x,
+        int y,
         BufferInterface* bufferInterface);
 
     void setWall(Direction direction);
@@ -27,6 +29,10 @@ public:
     void setText(const QString& text);
     void clearText();
 
+    // The setters above only change the state of the tile; this writes
+    // whatever parts of the state changed since the last flush to the buffers
+    void flush();
+
     // TODO: upforgrabs
     // Rename these to "reload" or something
     void drawPolygons() const;
@@ -35,7 +41,9 @@ public:
 private:
 
     // Input and output objects
-    const Tile* m_tile;
+    const Maze* m_maze;
+    int m_x;
+    int m_y;
     BufferInterface* m_bufferInterface;
 
     // Visual state
@@ -43,6 +51,11 @@ private:
     Color m_color;
     QString m_text;
 
+    // The visual state as of the last flush, i.e., what's in the buffers
+    unsigned char m_flushedWallAlphas[4];
+    Color m_flushedColor;
+    QString m_flushedText;
+
     // Helper functions
     // TODO: upforgrabs
     // Rename these to "refresh" or something
@@ -13,42 +13,51 @@ void TileGraphicTextCache::init(
     m_wallLength = wallLength;
     m_wallWidth = wallWidth;
     m_tileGraphicTextMaxSize = tileGraphicTextMaxSize;
-    m_tileGraphicTextPositions = buildPositionCache();
+    m_tileLength = (wallLength + wallWidth).getMeters();
+    buildFontImageCharacterPositions();
+    buildRectangleCache();
 }
 
 QPair<int, int> TileGraphicTextCache::getTileGraphicTextMaxSize() const {
     return m_tileGraphicTextMaxSize;
 }
 
-QPair<double, double> TileGraphicTextCache::getFontImageCharacterPosition(QChar c) const {
-    ASSERT_TR(FontImage::positions().contains(c));
-    return FontImage::positions().value(c);
+const QPair<double, double>& TileGraphicTextCache::getFontImageCharacterPosition(QChar c) const {
+    return m_fontImageCharacterPositions[
+        c.unicode() < NUM_GLYPHS ? c.unicode() : UNKNOWN
+    ];
 }
 
-QPair<Coordinate, Coordinate> TileGraphicTextCache::getTileGraphicTextPosition(
-        int x, int y, int numRows, int numCols, int row, int col) const {
+const TileGraphicTextRectangle& TileGraphicTextCache::getTileGraphicTextRectangle(
+        int numRows, int numCols, int row, int col) const {
+    return m_tileGraphicTextRectangles.at(
+        getTileGraphicTextRectangleIndex(numRows, numCols, row, col));
+}
 
-    // Get the character position in the maze for the starting tile
-    QPair<Coordinate, Coordinate> textPosition = m_tileGraphicTextPositions.value(
-        {
-            {numRows, numCols},
-            {row, col}
-        }
-    );
+double TileGraphicTextCache::getTileOffset(int x) const {
+    return m_tileLength * x;
+}
 
-    // Now get the character position in the maze for *this* tile
-    Distance tileLength = m_wallLength + m_wallWidth;
-    Coordinate offset = Coordinate::Cartesian(tileLength * x, tileLength * y);
-    Coordinate LL = textPosition.first + offset;
-    Coordinate UR = textPosition.second + offset;
+int TileGraphicTextCache::getTileGraphicTextRectangleIndex(
+        int numRows, int numCols, int row, int col) const {
+    int maxRows = m_tileGraphicTextMaxSize.first;
+    int maxCols = m_tileGraphicTextMaxSize.second;
+    return ((numRows * (maxCols + 1) + numCols) * maxRows + row) * maxCols + col;
+}
 
-    return {LL, UR};
+void TileGraphicTextCache::buildFontImageCharacterPositions() {
+    ASSERT_TR(FontImage::positions().contains(UNKNOWN));
+    for (int i = 0; i < NUM_GLYPHS; i += 1) {
+        m_fontImageCharacterPositions[i] = FontImage::positions().value(UNKNOWN);
+    }
+    for (QChar c : FontImage::characters()) {
+        ASSERT_LT(c.unicode(), NUM_GLYPHS);
+        m_fontImageCharacterPositions[c.unicode()] =
+            FontImage::positions().value(c);
+    }
 }
 
-QMap<
-    QPair<QPair<int, int>, QPair<int, int>>,
-    QPair<Coordinate, Coordinate>>
-TileGraphicTextCache::buildPositionCache() {
+void TileGraphicTextCache::buildRectangleCache() {
 
     // The tile graphic text could look like either of the following, depending
     // on the layout, border, and max size
@@ -71,12 +80,13 @@ TileGraphicTextCache::buildPositionCache() {
     //     *[A]--------------------------*-*    *[A]--------------------------*-*
     //     *-*---------------------------*-*    *-*---------------------------*-*
 
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Coordinate, Coordinate>> positionCache;
-
     int maxRows = m_tileGraphicTextMaxSize.first;
     int maxCols = m_tileGraphicTextMaxSize.second;
+
+    // Rows and cols that aren't visible keep an empty rectangle
+    m_tileGraphicTextRectangles.fill(
+        {0.0, 0.0, 0.0, 0.0},
+        (maxRows + 1) * (maxCols + 1) * maxRows * maxCols);
     double borderFraction = 0.05;  // border padding
 
     // First we get the unscaled diagonal
@@ -123,20 +133,20 @@ TileGraphicTextCache::buildPositionCache() {
                         E.getY() + characterHeight * ((numRows - row - 1) + rowOffset + 1)
                     );
 
-                    // Insert the position into the cache
-                    positionCache.insert(
-                        {
-                            {numRows, numCols}, // Num rows/cols to be drawn
-                            {row, col} // Row and col of the current character
-                        },
-                        {LL, UR} // Lower left and upper right texture coord
-                    );
+                    // Insert the rectangle into the cache
+                    m_tileGraphicTextRectangles[
+                        getTileGraphicTextRectangleIndex(
+                            numRows, numCols, row, col)
+                    ] = {
+                        LL.getX().getMeters(),
+                        LL.getY().getMeters(),
+                        UR.getX().getMeters(),
+                        UR.getY().getMeters(),
+                    };
                 }
             }
         }
     }
-
-    return positionCache;
 }
 
 } 
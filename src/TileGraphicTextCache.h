@@ -1,13 +1,22 @@
 #pragma once
 
 #include <QChar>
-#include <QMap>
 #include <QPair>
+#include <QVector>
 
 #include "units/Coordinate.h"
 
 namespace mms {
 
+// The lower left and upper right corners of a character of tile graphic text,
+// in meters, relative to the starting tile, namely tile (0, 0)
+struct TileGraphicTextRectangle {
+    double left;
+    double bottom;
+    double right;
+    double top;
+};
+
 class TileGraphicTextCache {
 
 public:
@@ -21,12 +30,17 @@ public:
     // Returns the max number of rows and columns of tile graphic text
     QPair<int, int> getTileGraphicTextMaxSize() const;
 
-    // Return a characters starting and ending position in the font image
-    QPair<double, double> getFontImageCharacterPosition(QChar c) const;
+    // Return a characters starting and ending position in the font image;
+    // characters that aren't in the font image get the position of UNKNOWN
+    const QPair<double, double>& getFontImageCharacterPosition(QChar c) const;
+
+    // Retrieve the rectangle for a particular row and col of the starting
+    // tile; the rectangle is empty if the row or col isn't visible
+    const TileGraphicTextRectangle& getTileGraphicTextRectangle(
+        int numRows, int numCols, int row, int col) const;
 
-    // Retrieve the LL and UR coordinates for a particular location
-    QPair<Coordinate, Coordinate> getTileGraphicTextPosition(
-        int x, int y, int numRows, int numCols, int row, int col) const;
+    // The offset, in meters, from the starting tile to tile (x, y)
+    double getTileOffset(int x) const;
 
 private:
 
@@ -37,16 +51,27 @@ private:
     // The max rows and cols of text per tile
     QPair<int, int> m_tileGraphicTextMaxSize;
 
-    // A map of the number of rows/cols to be displayed and the current row/col
-    // to the LL/UR text coordinates for the starting tile, namely tile (0, 0)
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Coordinate, Coordinate>> m_tileGraphicTextPositions;
+    // The distance between the starting points of adjacent tiles, in meters
+    double m_tileLength;
+
+    // The character displayed in place of those that aren't in the font image
+    static const char UNKNOWN = '?';
+
+    // The font image position of each Latin-1 character, indexed by its code,
+    // which doubles as the filter for unknown characters: their entries hold
+    // the position of UNKNOWN, as does everything past the end of the table
+    static const int NUM_GLYPHS = 256;
+    QPair<double, double> m_fontImageCharacterPositions[NUM_GLYPHS];
+
+    // The text rectangles for the starting tile, for every number of rows and
+    // cols to be displayed and every row and col, densely packed
+    QVector<TileGraphicTextRectangle> m_tileGraphicTextRectangles;
+    int getTileGraphicTextRectangleIndex(
+        int numRows, int numCols, int row, int col) const;
 
-    // Just a helper method for building the text position cache
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Coordinate, Coordinate>> buildPositionCache();
+    // Just helper methods for building the caches
+    void buildFontImageCharacterPositions();
+    void buildRectangleCache();
 };
 
 } 
@@ -0,0 +1,640 @@
+#include "Tournament.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include "CommandDispatcher.h"
+#include "CommandParser.h"
+#include "Direction.h"
+#include "MazeGenerator.h"
+#include "ProcessUtilities.h"
+#include "SettingsMouseAlgos.h"
+
+namespace mms {
+
+// QProcess needs a thread that was started by Qt, so the workers can't be
+// plain std::threads like those of the MazeGenerator
+class TournamentWorker : public QThread {
+public:
+    explicit TournamentWorker(std::function<void()> work) : m_work(work) {
+    }
+protected:
+    void run() override {
+        m_work();
+    }
+private:
+    std::function<void()> m_work;
+};
+
+// The mouse of a match, which is simulated one tile at a time, as if every
+// movement were instantaneous, and draws nothing. A trip starts whenever the
+// mouse is at the start (or is reset), and ends when it reaches the center.
+class TournamentMouse : public MouseInterface {
+public:
+    TournamentMouse(const Maze* maze, TournamentResult* result) :
+            m_maze(maze),
+            m_centers(maze->getWallGrid().getCenterPositions()),
+            m_result(result),
+            m_x(0),
+            m_y(0),
+            m_direction(Direction::NORTH),
+            m_moves(0),
+            m_trips(0),
+            m_tripStart(0),
+            m_isOnTrip(true),
+            m_isSupported(true) {
+    }
+    int getMoves() const {
+        return m_moves;
+    }
+    int getTrips() const {
+        return m_trips;
+    }
+    bool isSupported() const {
+        return m_isSupported;
+    }
+    int mazeWidth() override {
+        return m_maze->getWidth();
+    }
+    int mazeHeight() override {
+        return m_maze->getHeight();
+    }
+    bool wallFront() override {
+        return m_maze->isWall(m_x, m_y, m_direction);
+    }
+    bool wallRight() override {
+        return m_maze->isWall(
+            m_x, m_y, DIRECTION_ROTATE_RIGHT().value(m_direction));
+    }
+    bool wallLeft() override {
+        return m_maze->isWall(
+            m_x, m_y, DIRECTION_ROTATE_LEFT().value(m_direction));
+    }
+    QString moveForward() override {
+        if (wallFront()) {
+            return CommandDispatcher::CRASH;
+        }
+        switch (m_direction) {
+            case Direction::NORTH:
+                m_y += 1;
+                break;
+            case Direction::EAST:
+                m_x += 1;
+                break;
+            case Direction::SOUTH:
+                m_y -= 1;
+                break;
+            case Direction::WEST:
+                m_x -= 1;
+                break;
+        }
+        m_moves += 1;
+        if (m_x == 0 && m_y == 0) {
+            m_tripStart = m_moves;
+            m_isOnTrip = true;
+        }
+        else if (m_isOnTrip && m_centers.contains({m_x, m_y})) {
+            int tripLength = m_moves - m_tripStart;
+            if (m_result->bestRunLength == -1 ||
+                    tripLength < m_result->bestRunLength) {
+                m_result->bestRunLength = tripLength;
+            }
+            if (m_result->explorationSteps == -1) {
+                m_result->explorationSteps = m_moves;
+            }
+            m_trips += 1;
+            m_isOnTrip = false;
+        }
+        return CommandDispatcher::ACK;
+    }
+    QString turnRight() override {
+        m_direction = DIRECTION_ROTATE_RIGHT().value(m_direction);
+        return CommandDispatcher::ACK;
+    }
+    QString turnLeft() override {
+        m_direction = DIRECTION_ROTATE_LEFT().value(m_direction);
+        return CommandDispatcher::ACK;
+    }
+    void setWheelSpeeds(int, int) override {
+        m_isSupported = false;
+    }
+    QPair<int, int> readEncoders() override {
+        m_isSupported = false;
+        return {0, 0};
+    }
+    QVector<double> readSensors() override {
+        m_isSupported = false;
+        return QVector<double>();
+    }
+    void setWall(int, int, QChar) override {
+    }
+    void clearWall(int, int, QChar) override {
+    }
+    void setColor(int, int, QChar) override {
+    }
+    void clearColor(int, int) override {
+    }
+    void clearAllColor() override {
+    }
+    void setText(int, int, const QString&) override {
+    }
+    void clearText(int, int) override {
+    }
+    void clearAllText() override {
+    }
+    bool wasReset() override {
+        return false;
+    }
+    void ackReset() override {
+        m_x = 0;
+        m_y = 0;
+        m_direction = Direction::NORTH;
+        m_tripStart = m_moves;
+        m_isOnTrip = true;
+    }
+private:
+    const Maze* m_maze;
+    QVector<QPair<int, int>> m_centers;
+    TournamentResult* m_result;
+    int m_x;
+    int m_y;
+    Direction m_direction;
+    int m_moves;
+    int m_trips;
+    int m_tripStart;
+    bool m_isOnTrip;
+    bool m_isSupported;
+};
+
+const int Tournament::DEFAULT_GENERATED_MAZE_COUNT = 16;
+const int Tournament::GENERATED_MAZE_SIZE = 16;
+const int Tournament::MAX_MOVES_PER_TILE = 64;
+const int Tournament::MAX_TRIPS = 3;
+const int Tournament::TIMEOUT_MILLISECONDS = 60000;
+
+QJsonObject TournamentResult::toJson() const {
+    QJsonObject object;
+    object["algo"] = algo;
+    object["maze"] = maze;
+    object["solved"] = isSolved;
+    object["supported"] = isSupported;
+    object["explorationSteps"] = explorationSteps;
+    object["bestRunLength"] = bestRunLength;
+    object["wallTimeSeconds"] = wallTimeSeconds;
+    return object;
+}
+
+TournamentResult TournamentResult::fromJson(const QJsonObject& object) {
+    TournamentResult result;
+    result.algo = object["algo"].toString();
+    result.maze = object["maze"].toString();
+    result.isSolved = object["solved"].toBool();
+    result.isSupported = object["supported"].toBool(true);
+    result.explorationSteps = object["explorationSteps"].toInt(-1);
+    result.bestRunLength = object["bestRunLength"].toInt(-1);
+    result.wallTimeSeconds = object["wallTimeSeconds"].toDouble();
+    result.isComplete = true;
+    result.isCached = true;
+    return result;
+}
+
+Tournament::Tournament(const QStringList& algos, const QStringList& mazeFiles) {
+    for (const QString& name : algos) {
+        Algo algo;
+        algo.name = name;
+        algo.directory = SettingsMouseAlgos::getDirectory(name);
+        algo.runCommand = SettingsMouseAlgos::getRunCommand(name);
+        algo.hash = hashAlgo(algo.directory, algo.runCommand);
+        m_algos.append(algo);
+    }
+    for (const QString& path : mazeFiles) {
+        Maze* maze = Maze::fromFile(path);
+        if (maze == nullptr) {
+            qWarning().noquote() << "Skipping invalid maze file" << path;
+            continue;
+        }
+        m_mazeNames.append(path);
+        m_mazes.append(maze);
+        m_mazeHashes.append(hashMaze(maze));
+    }
+}
+
+Tournament::~Tournament() {
+    for (Maze* maze : m_mazes) {
+        delete maze;
+    }
+}
+
+void Tournament::addGeneratedMazes(int count, quint64 seed) {
+    QVector<WallGrid> grids = MazeGenerator::generateBatch(
+        MazeGeneratorType::TOMASZ,
+        GENERATED_MAZE_SIZE,
+        GENERATED_MAZE_SIZE,
+        seed,
+        count,
+        true);
+    for (int i = 0; i < grids.size(); i += 1) {
+        Maze* maze = Maze::fromWallGrid(grids.at(i));
+        if (maze == nullptr) {
+            continue;
+        }
+        m_mazeNames.append(QString("generated-%1-%2").arg(
+            QString::number(seed),
+            QString::number(i)
+        ));
+        m_mazes.append(maze);
+        m_mazeHashes.append(hashMaze(maze));
+    }
+}
+
+bool Tournament::run(const QString& cachePath) {
+
+    // Fill in the cached results, collect the rest
+    QMap<QString, QJsonObject> cache = readCache(cachePath);
+    QVector<QPair<int, int>> pending;
+    m_results = QVector<QVector<TournamentResult>>(m_algos.size());
+    for (int a = 0; a < m_algos.size(); a += 1) {
+        m_results[a].resize(m_mazes.size());
+        for (int m = 0; m < m_mazes.size(); m += 1) {
+            QString key = cacheKey(m_algos.at(a).hash, m_mazeHashes.at(m));
+            if (cache.contains(key)) {
+                TournamentResult result =
+                    TournamentResult::fromJson(cache.value(key));
+                result.algo = m_algos.at(a).name;
+                result.maze = m_mazeNames.at(m);
+                m_results[a][m] = result;
+            }
+            else {
+                pending.append({a, m});
+            }
+        }
+    }
+    qInfo().noquote() << QString("Running %1 matches, %2 cached").arg(
+        QString::number(pending.size()),
+        QString::number(m_algos.size() * m_mazes.size() - pending.size())
+    );
+
+    // Each complete match is appended to the cache right away, so that an
+    // interrupted tournament can be resumed
+    QFile cacheFile(cachePath);
+    bool isCacheWritable =
+        cacheFile.open(QIODevice::WriteOnly | QIODevice::Append);
+    std::mutex mutex;
+    std::atomic<int> next(0);
+    int finished = 0;
+    auto work = [&]() {
+        while (true) {
+            int index = next.fetch_add(1);
+            if (pending.size() <= index) {
+                return;
+            }
+            int a = pending.at(index).first;
+            int m = pending.at(index).second;
+            TournamentResult result = runMatch(m_algos.at(a), m_mazes.at(m));
+            result.maze = m_mazeNames.at(m);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            m_results[a][m] = result;
+            if (isCacheWritable && result.isComplete) {
+                QJsonObject entry;
+                entry["key"] =
+                    cacheKey(m_algos.at(a).hash, m_mazeHashes.at(m));
+                entry["result"] = result.toJson();
+                cacheFile.write(
+                    QJsonDocument(entry).toJson(QJsonDocument::Compact) + "\n");
+                cacheFile.flush();
+            }
+            finished += 1;
+            qInfo().noquote() << QString("[%1/%2] %3 in %4: %5").arg(
+                QString::number(finished),
+                QString::number(pending.size()),
+                result.algo,
+                result.maze,
+                !result.isComplete
+                    ? QString("incomplete, failed to start or timed out")
+                    : result.isSolved
+                    ? QString("best run of %1").arg(result.bestRunLength)
+                    : result.isSupported
+                    ? QString("unsolved")
+                    : QString("unsupported, uses the wheels or sensors")
+            );
+        }
+    };
+
+    // Each worker spends most of its time waiting on its algorithm, which
+    // gets a core of its own
+    int numThreads =
+        qBound(1, QThread::idealThreadCount(), qMax(1, pending.size()));
+    QVector<TournamentWorker*> workers;
+    for (int i = 0; i < numThreads; i += 1) {
+        workers.append(new TournamentWorker(work));
+        workers.last()->start();
+    }
+    for (TournamentWorker* worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+    return isCacheWritable || pending.isEmpty();
+}
+
+bool Tournament::writeCsv(const QString& path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QTextStream stream(&file);
+
+    // One row per algorithm, in order of rank, with the best run length in
+    // each maze (empty if unsolved)
+    QStringList header = {
+        "rank",
+        "algorithm",
+        "supported",
+        "solve rate",
+        "mean exploration steps",
+        "mean best run length",
+        "total wall time (s)",
+    };
+    for (const QString& name : m_mazeNames) {
+        header.append(csvField(name));
+    }
+    stream << header.join(",") << "\n";
+
+    QVector<Standing> standings = rank();
+    for (int i = 0; i < standings.size(); i += 1) {
+        const Standing& standing = standings.at(i);
+        QStringList row = {
+            QString::number(i + 1),
+            csvField(standing.algo),
+            standing.isSupported ? "true" : "false",
+            QString::number(standing.solveRate),
+            QString::number(standing.meanExplorationSteps),
+            QString::number(standing.meanBestRunLength),
+            QString::number(standing.totalWallTimeSeconds),
+        };
+        for (int a = 0; a < m_algos.size(); a += 1) {
+            if (m_algos.at(a).name != standing.algo) {
+                continue;
+            }
+            for (const TournamentResult& result : m_results.at(a)) {
+                row.append(
+                    result.isSolved
+                    ? QString::number(result.bestRunLength)
+                    : QString()
+                );
+            }
+        }
+        stream << row.join(",") << "\n";
+    }
+    return stream.status() == QTextStream::Ok;
+}
+
+bool Tournament::writeJson(const QString& path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QJsonArray mazes;
+    for (int m = 0; m < m_mazes.size(); m += 1) {
+        QJsonObject maze;
+        maze["name"] = m_mazeNames.at(m);
+        maze["hash"] = m_mazeHashes.at(m);
+        mazes.append(maze);
+    }
+    QJsonArray algos;
+    QVector<Standing> standings = rank();
+    for (int i = 0; i < standings.size(); i += 1) {
+        const Standing& standing = standings.at(i);
+        for (int a = 0; a < m_algos.size(); a += 1) {
+            if (m_algos.at(a).name != standing.algo) {
+                continue;
+            }
+            QJsonArray results;
+            for (const TournamentResult& result : m_results.at(a)) {
+                QJsonObject object = result.toJson();
+                object["cached"] = result.isCached;
+                results.append(object);
+            }
+            QJsonObject algo;
+            algo["rank"] = i + 1;
+            algo["name"] = standing.algo;
+            algo["hash"] = m_algos.at(a).hash;
+            algo["supported"] = standing.isSupported;
+            algo["solveRate"] = standing.solveRate;
+            algo["meanExplorationSteps"] = standing.meanExplorationSteps;
+            algo["meanBestRunLength"] = standing.meanBestRunLength;
+            algo["totalWallTimeSeconds"] = standing.totalWallTimeSeconds;
+            algo["results"] = results;
+            algos.append(algo);
+        }
+    }
+    QJsonObject object;
+    object["mazes"] = mazes;
+    object["algorithms"] = algos;
+    return file.write(QJsonDocument(object).toJson()) != -1;
+}
+
+TournamentResult Tournament::runMatch(const Algo& algo, const Maze* maze) {
+
+    TournamentResult result;
+    result.algo = algo.name;
+    result.isSolved = false;
+    result.explorationSteps = -1;
+    result.bestRunLength = -1;
+    result.wallTimeSeconds = 0.0;
+    result.isSupported = true;
+    result.isComplete = true;
+    result.isCached = false;
+
+    QElapsedTimer timer;
+    timer.start();
+    QProcess process;
+    process.setStandardErrorFile(QProcess::nullDevice());
+    if (!ProcessUtilities::start(algo.runCommand, algo.directory, &process)) {
+        result.isComplete = false;
+        return result;
+    }
+
+    int maxMoves =
+        MAX_MOVES_PER_TILE * maze->getWidth() * maze->getHeight();
+    TournamentMouse mouse(maze, &result);
+
+    QByteArray buffer;
+    int start = 0;
+    while (mouse.getTrips() < MAX_TRIPS && mouse.getMoves() < maxMoves) {
+
+        // Wait for more output once every complete line has been handled;
+        // waiting also writes the responses that are still pending
+        int end = buffer.indexOf('\n', start);
+        if (end == -1) {
+            buffer.remove(0, start);
+            start = 0;
+            int remaining = TIMEOUT_MILLISECONDS - timer.elapsed();
+            if (remaining <= 0 || !process.waitForReadyRead(remaining)) {
+                // An algorithm that exited on its own is done, but one that's
+                // still running simply ran out of time
+                result.isComplete = process.state() == QProcess::NotRunning;
+                break;
+            }
+            buffer.append(process.readAllStandardOutput());
+            continue;
+        }
+        int length = end - start;
+        if (0 < length && buffer.at(end - 1) == '\r') {
+            length -= 1;  // Windows compatibility
+        }
+        Command command =
+            CommandParser::parse(buffer.constData() + start, length);
+        start = end + 1;
+
+        // There's no point in waiting for an algorithm that relies on
+        // commands that the tournament can't answer
+        QString response = CommandDispatcher::execute(&mouse, command);
+        if (!mouse.isSupported()) {
+            result.isSupported = false;
+            break;
+        }
+        if (!response.isEmpty() && response != CommandDispatcher::INVALID) {
+            process.write((response + "\n").toUtf8());
+        }
+    }
+
+    // Most algorithms never exit on their own
+    if (process.state() != QProcess::NotRunning) {
+        process.kill();
+        process.waitForFinished();
+    }
+    result.isSolved = result.bestRunLength != -1;
+    result.wallTimeSeconds = timer.elapsed() / 1000.0;
+    return result;
+}
+
+QVector<Tournament::Standing> Tournament::rank() const {
+
+    // Means are over the solved mazes only, and are -1 if there are none
+    QVector<Standing> standings;
+    for (int a = 0; a < m_algos.size(); a += 1) {
+        Standing standing;
+        standing.algo = m_algos.at(a).name;
+        standing.isSupported = true;
+        standing.totalWallTimeSeconds = 0.0;
+        int solved = 0;
+        double explorationSteps = 0.0;
+        double bestRunLength = 0.0;
+        for (const TournamentResult& result : m_results.at(a)) {
+            standing.totalWallTimeSeconds += result.wallTimeSeconds;
+            standing.isSupported = standing.isSupported && result.isSupported;
+            if (result.isSolved) {
+                solved += 1;
+                explorationSteps += result.explorationSteps;
+                bestRunLength += result.bestRunLength;
+            }
+        }
+        standing.solveRate = m_mazes.isEmpty()
+            ? 0.0
+            : static_cast<double>(solved) / m_mazes.size();
+        standing.meanExplorationSteps =
+            0 < solved ? explorationSteps / solved : -1.0;
+        standing.meanBestRunLength =
+            0 < solved ? bestRunLength / solved : -1.0;
+        standings.append(standing);
+    }
+
+    // Solve the most mazes, then take the fewest steps doing it; algorithms
+    // that the tournament doesn't support come last, whatever they solved
+    std::stable_sort(
+        standings.begin(),
+        standings.end(),
+        [](const Standing& one, const Standing& two) {
+            if (one.isSupported != two.isSupported) {
+                return one.isSupported;
+            }
+            if (one.solveRate != two.solveRate) {
+                return one.solveRate > two.solveRate;
+            }
+            if (one.meanBestRunLength != two.meanBestRunLength) {
+                return one.meanBestRunLength < two.meanBestRunLength;
+            }
+            return one.meanExplorationSteps < two.meanExplorationSteps;
+        }
+    );
+    return standings;
+}
+
+QString Tournament::hashAlgo(
+        const QString& directory,
+        const QString& runCommand) {
+
+    // There's no telling which file is the algorithm, so hash the command
+    // along with every argument of it that's a file in the directory, e.g.,
+    // the binary in "./a.out" or the script in "python3 main.py"
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(runCommand.toUtf8());
+    for (const QString& arg : runCommand.split(' ', QString::SkipEmptyParts)) {
+        QFileInfo info(QDir(directory), arg);
+        if (!info.isFile()) {
+            continue;
+        }
+        QFile file(info.absoluteFilePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            hash.addData(&file);
+        }
+    }
+    return hash.result().toHex();
+}
+
+QString Tournament::hashMaze(const Maze* maze) {
+    const WallGrid& grid = maze->getWallGrid();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(grid.getWidth()) + "x" +
+        QByteArray::number(grid.getHeight()));
+    hash.addData(
+        reinterpret_cast<const char*>(grid.data()),
+        grid.getWidth() * grid.getHeight()
+    );
+    return hash.result().toHex();
+}
+
+QString Tournament::csvField(const QString& field) {
+    if (!field.contains(',') && !field.contains('"')) {
+        return field;
+    }
+    QString escaped = field;
+    return "\"" + escaped.replace("\"", "\"\"") + "\"";
+}
+
+QString Tournament::cacheKey(const QString& algoHash, const QString& mazeHash) {
+    return algoHash + "/" + mazeHash;
+}
+
+QMap<QString, QJsonObject> Tournament::readCache(const QString& path) {
+    // One entry per line; later entries win
+    QMap<QString, QJsonObject> cache;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return cache;
+    }
+    while (!file.atEnd()) {
+        QJsonObject entry = QJsonDocument::fromJson(file.readLine()).object();
+        if (entry.contains("key") && entry["result"].isObject()) {
+            cache.insert(entry["key"].toString(), entry["result"].toObject());
+        }
+    }
+    return cache;
+}
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "Maze.h"
+
+namespace mms {
+
+// The outcome of one algorithm in one maze
+struct TournamentResult {
+
+    QString algo;
+    QString maze;
+
+    // Whether the mouse ever reached the center, the number of moves it took
+    // to get there the first time, and the fewest moves of any trip from the
+    // start to the center (-1 if it never got there)
+    bool isSolved;
+    int explorationSteps;
+    int bestRunLength;
+    double wallTimeSeconds;
+
+    // Whether the algorithm only used commands that the tournament supports;
+    // the wheels and sensors aren't simulated, so an algorithm that uses them
+    // is stopped as soon as it does, and can't be ranked
+    bool isSupported;
+
+    // Whether the match ran its course; a match whose algorithm couldn't be
+    // started or ran out of time might go differently next time, so it isn't
+    // cached
+    bool isComplete;
+
+    // Whether the result came from the cache instead of a run
+    bool isCached;
+
+    QJsonObject toJson() const;
+    static TournamentResult fromJson(const QJsonObject& object);
+};
+
+// Runs every algorithm in every maze, on all cores and without graphics, and
+// ranks the algorithms. Results are cached by the hashes of the algorithm and
+// the maze, so re-running a tournament only runs the algorithms (or mazes)
+// that changed, and an interrupted tournament picks up where it left off.
+class Tournament {
+
+public:
+
+    static const int DEFAULT_GENERATED_MAZE_COUNT;
+
+    Tournament(const QStringList& algos, const QStringList& mazeFiles);
+    ~Tournament();
+
+    // Adds count official mazes, made by the MazeGenerator, to the mazes
+    void addGeneratedMazes(int count, quint64 seed);
+
+    // Runs every algorithm in every maze, blocking until all results are in;
+    // returns false if the cache couldn't be written
+    bool run(const QString& cachePath);
+
+    // Writes the ranked results matrix
+    bool writeCsv(const QString& path) const;
+    bool writeJson(const QString& path) const;
+
+private:
+
+    static const int GENERATED_MAZE_SIZE;
+    static const int MAX_MOVES_PER_TILE;
+    static const int MAX_TRIPS;
+    static const int TIMEOUT_MILLISECONDS;
+
+    // Everything that's needed to run an algorithm, resolved on the main
+    // thread since the settings aren't thread safe
+    struct Algo {
+        QString name;
+        QString directory;
+        QString runCommand;
+        QString hash;
+    };
+
+    // The summary of the results of one algorithm, used for the ranking
+    struct Standing {
+        QString algo;
+        bool isSupported;
+        double solveRate;
+        double meanExplorationSteps;
+        double meanBestRunLength;
+        double totalWallTimeSeconds;
+    };
+
+    QVector<Algo> m_algos;
+    QStringList m_mazeNames;
+    QVector<Maze*> m_mazes;
+    QStringList m_mazeHashes;
+
+    // Indexed by algo and then by maze
+    QVector<QVector<TournamentResult>> m_results;
+
+    static TournamentResult runMatch(const Algo& algo, const Maze* maze);
+    QVector<Standing> rank() const;
+
+    static QString hashAlgo(const QString& directory, const QString& runCommand);
+    static QString hashMaze(const Maze* maze);
+    static QString csvField(const QString& field);
+    static QString cacheKey(const QString& algoHash, const QString& mazeHash);
+    static QMap<QString, QJsonObject> readCache(const QString& path);
+};
+
+}
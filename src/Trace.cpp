@@ -0,0 +1,132 @@
+#include "Trace.h"
+
+#include <QFile>
+#include <QTextStream>
+
+#include <chrono>
+
+namespace mms {
+
+const int Trace::EVENTS_PER_THREAD = 64 * 1024;
+
+void Trace::begin(const char* name) {
+    record(name, 'B');
+}
+
+void Trace::end(const char* name) {
+    record(name, 'E');
+}
+
+void Trace::setThreadName(const char* name) {
+    ThreadBuffer* buffer = getThreadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->name = name;
+}
+
+bool Trace::write(const QString& path) {
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QTextStream stream(&file);
+
+    // Chrome trace timestamps are in microseconds
+    stream << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto writeEvent = [&](
+            const char* name, char phase, double timestamp, int threadId) {
+        stream << (first ? "" : ",\n")
+               << "{\"name\":\"" << name
+               << "\",\"ph\":\"" << phase
+               << "\",\"ts\":" << QString::number(timestamp, 'f', 3)
+               << ",\"pid\":0,\"tid\":" << threadId << "}";
+        first = false;
+    };
+
+    QMutexLocker buffersLocker(getThreadBuffersMutex());
+    for (ThreadBuffer* buffer : *getThreadBuffers()) {
+        QMutexLocker locker(&buffer->mutex);
+
+        if (buffer->name != nullptr) {
+            stream << (first ? "" : ",\n")
+                   << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                   << "\"tid\":" << buffer->id
+                   << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+            first = false;
+        }
+
+        // Walk the ring from the oldest event to the newest, dropping end
+        // events whose begin events have already been overwritten
+        qint64 start = qMax(qint64(0), buffer->count - EVENTS_PER_THREAD);
+        int depth = 0;
+        for (qint64 i = start; i < buffer->count; i += 1) {
+            const Event& event = buffer->events.at(i % EVENTS_PER_THREAD);
+            if (event.phase == 'E') {
+                if (depth == 0) {
+                    continue;
+                }
+                depth -= 1;
+            }
+            else {
+                depth += 1;
+            }
+            writeEvent(
+                event.name,
+                event.phase,
+                event.timestamp / 1000.0,
+                buffer->id
+            );
+        }
+    }
+
+    stream << "\n]}\n";
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
+
+void Trace::record(const char* name, char phase) {
+    qint64 timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+    ThreadBuffer* buffer = getThreadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->events[buffer->count % EVENTS_PER_THREAD] = {
+        name,
+        timestamp,
+        phase,
+    };
+    buffer->count += 1;
+}
+
+Trace::ThreadBuffer* Trace::getThreadBuffer() {
+
+    // The buffers are never deleted, so that the events of threads that have
+    // already finished still show up in the trace
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer != nullptr) {
+        return buffer;
+    }
+
+    buffer = new ThreadBuffer();
+    buffer->name = nullptr;
+    buffer->events.resize(EVENTS_PER_THREAD);
+    buffer->count = 0;
+
+    QMutexLocker locker(getThreadBuffersMutex());
+    buffer->id = getThreadBuffers()->size();
+    getThreadBuffers()->append(buffer);
+    return buffer;
+}
+
+QMutex* Trace::getThreadBuffersMutex() {
+    static QMutex mutex;
+    return &mutex;
+}
+
+QVector<Trace::ThreadBuffer*>* Trace::getThreadBuffers() {
+    static QVector<ThreadBuffer*> buffers;
+    return &buffers;
+}
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+namespace mms {
+
+// Records begin and end events into a fixed-size ring buffer per thread, and
+// writes the most recent events of every thread as Chrome trace JSON, which
+// can be opened with chrome://tracing or https://ui.perfetto.dev. Use the
+// TRACE_SCOPE macro rather than calling begin and end directly.
+class Trace {
+
+public:
+
+    // The Trace class is not constructible
+    Trace() = delete;
+
+    // Event names must outlive the trace, i.e., be string literals
+    static void begin(const char* name);
+    static void end(const char* name);
+
+    // Names the calling thread in the trace
+    static void setThreadName(const char* name);
+
+    // Returns true if the trace was written successfully
+    static bool write(const QString& path);
+
+private:
+
+    static const int EVENTS_PER_THREAD;
+
+    struct Event {
+        const char* name;
+        qint64 timestamp;
+        char phase;
+    };
+
+    // Only the owning thread writes events, so the mutex is uncontended
+    // except while the trace is being written
+    struct ThreadBuffer {
+        int id;
+        const char* name;
+        QMutex mutex;
+        QVector<Event> events;
+        qint64 count;
+    };
+
+    static void record(const char* name, char phase);
+    static ThreadBuffer* getThreadBuffer();
+    static QMutex* getThreadBuffersMutex();
+    static QVector<ThreadBuffer*>* getThreadBuffers();
+};
+
+class TraceScope {
+
+public:
+
+    TraceScope(const char* name) : m_name(name) {
+        Trace::begin(m_name);
+    }
+
+    ~TraceScope() {
+        Trace::end(m_name);
+    }
+
+private:
+
+    const char* m_name;
+};
+
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Trace.h"
+
+#define TRACE_CONCAT_INNER(lhs, rhs) lhs##rhs
+#define TRACE_CONCAT(lhs, rhs) TRACE_CONCAT_INNER(lhs, rhs)
+
+// Records a begin event for the given name, which must be a string literal,
+// and the matching end event when the enclosing scope exits
+#define TRACE_SCOPE(name)\
+mms::TraceScope TRACE_CONCAT(traceScope, __LINE__)(name);
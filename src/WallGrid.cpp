@@ -0,0 +1,98 @@
+#include "WallGrid.h"
+
+#include "AssertMacros.h"
+
+namespace mms {
+
+WallGrid::WallGrid() :
+    m_width(0),
+    m_height(0) {
+}
+
+WallGrid::WallGrid(int width, int height) :
+    m_width(width),
+    m_height(height),
+    m_walls(width * height, 0) {
+    ASSERT_LE(0, width);
+    ASSERT_LE(0, height);
+}
+
+int WallGrid::getWidth() const {
+    return m_width;
+}
+
+int WallGrid::getHeight() const {
+    return m_height;
+}
+
+bool WallGrid::isEmpty() const {
+    return m_width == 0 || m_height == 0;
+}
+
+int WallGrid::getIndex(int x, int y) const {
+    return m_height * x + y;
+}
+
+unsigned char WallGrid::getWalls(int x, int y) const {
+    return m_walls.at(getIndex(x, y));
+}
+
+bool WallGrid::isWall(int x, int y, Direction direction) const {
+    return (getWalls(x, y) & bit(direction)) != 0;
+}
+
+void WallGrid::setWalls(int x, int y, unsigned char walls) {
+    m_walls[getIndex(x, y)] = walls;
+}
+
+void WallGrid::setWall(int x, int y, Direction direction, bool isWall) {
+    unsigned char& walls = m_walls[getIndex(x, y)];
+    if (isWall) {
+        walls |= bit(direction);
+    }
+    else {
+        walls &= ~bit(direction);
+    }
+}
+
+QVector<QPair<int, int>> WallGrid::getCenterPositions() const {
+
+    // +---+---+
+    // | C | D |
+    // +---+---+
+    // | A | B |
+    // +---+---+
+    QPair<int, int> A = {(m_width - 1) / 2, (m_height - 1) / 2};
+    QPair<int, int> B = {m_width / 2, (m_height - 1) / 2};
+    QPair<int, int> C = {(m_width - 1) / 2, m_height / 2};
+    QPair<int, int> D = {m_width / 2, m_height / 2};
+
+    QVector<QPair<int, int>> positions;
+    positions.append(A);
+    if (m_width % 2 == 0 && m_height % 2 == 0) {
+        positions.append(B);
+        positions.append(C);
+        positions.append(D);
+    }
+    else if (m_width % 2 == 0) {
+        positions.append(B);
+    }
+    else if (m_height % 2 == 0) {
+        positions.append(C);
+    }
+    return positions;
+}
+
+unsigned char WallGrid::bit(Direction direction) {
+    return static_cast<unsigned char>(1 << static_cast<int>(direction));
+}
+
+const unsigned char* WallGrid::data() const {
+    return m_walls.constData();
+}
+
+unsigned char* WallGrid::data() {
+    return m_walls.data();
+}
+
+}
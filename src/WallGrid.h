@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QPair>
+#include <QVector>
+
+#include "Direction.h"
+
+namespace mms {
+
+// A compact, flat representation of the walls of a maze. Each tile is stored
+// as a single byte whose low four bits are the NORTH, EAST, SOUTH, and WEST
+// walls (in the order of DIRECTIONS()). Tiles are stored column-major, i.e.,
+// the tile at (x, y) lives at index (height * x + y), which matches the layout
+// of the graphic cpu buffer.
+class WallGrid {
+
+public:
+
+    WallGrid();
+    WallGrid(int width, int height);
+
+    int getWidth() const;
+    int getHeight() const;
+    bool isEmpty() const;
+
+    // The index of the tile at (x, y) in the flat representation
+    int getIndex(int x, int y) const;
+
+    // Returns the wall bits of the tile at (x, y)
+    unsigned char getWalls(int x, int y) const;
+    bool isWall(int x, int y, Direction direction) const;
+
+    // Note that these only modify the given tile, not its neighbor
+    void setWalls(int x, int y, unsigned char walls);
+    void setWall(int x, int y, Direction direction, bool isWall);
+
+    // Returns the one, two, or four tiles that make up the center of the maze
+    QVector<QPair<int, int>> getCenterPositions() const;
+
+    // Returns the bit corresponding to a particular direction
+    static unsigned char bit(Direction direction);
+
+    // Raw access to the flat representation
+    const unsigned char* data() const;
+    unsigned char* data();
+
+private:
+
+    int m_width;
+    int m_height;
+    QVector<unsigned char> m_walls;
+
+};
+
+}
@@ -0,0 +1,53 @@
+#include "Wheel.h"
+
+#include <QtGlobal>
+#include <QtMath>
+
+namespace mms {
+
+Wheel::Wheel(
+        const Distance& radius,
+        double maxRadiansPerSecond,
+        int encoderTicksPerRevolution) :
+    m_radius(radius),
+    m_angularVelocity(0.0),
+    m_maxAngularVelocity(maxRadiansPerSecond),
+    m_encoderTicksPerRevolution(encoderTicksPerRevolution),
+    m_rotation(0.0) {
+}
+
+Distance Wheel::getRadius() const {
+    return m_radius;
+}
+
+double Wheel::getAngularVelocity() const {
+    return m_angularVelocity;
+}
+
+double Wheel::getMaxAngularVelocity() const {
+    return m_maxAngularVelocity;
+}
+
+void Wheel::setAngularVelocity(double radiansPerSecond) {
+    m_angularVelocity = qBound(
+        -m_maxAngularVelocity,
+        radiansPerSecond,
+        m_maxAngularVelocity);
+}
+
+int Wheel::readEncoder() const {
+    // Round towards zero, so that backwards rotation is counted the same as
+    // forwards rotation
+    return static_cast<int>(
+        m_encoderTicksPerRevolution * m_rotation / (2 * M_PI));
+}
+
+void Wheel::resetEncoder() {
+    m_rotation = 0.0;
+}
+
+void Wheel::updateRotation(double radians) {
+    m_rotation += radians;
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "units/Distance.h"
+
+namespace mms {
+
+// A wheel of the continuously simulated mouse: a motor, whose angular velocity
+// is set by the algorithm, and an encoder, which counts how far it turned
+class Wheel {
+
+public:
+
+    Wheel(
+        const Distance& radius,
+        double maxRadiansPerSecond,
+        int encoderTicksPerRevolution);
+
+    // Wheel
+    Distance getRadius() const;
+
+    // Motor, in radians per second; the magnitude is capped at the max
+    double getAngularVelocity() const;
+    double getMaxAngularVelocity() const;
+    void setAngularVelocity(double radiansPerSecond);
+
+    // Encoder, in ticks since the last reset, which are negative if the
+    // wheel turned backwards
+    int readEncoder() const;
+    void resetEncoder();
+    void updateRotation(double radians);
+
+private:
+
+    // Wheel
+    Distance m_radius;
+
+    // Motor
+    double m_angularVelocity;
+    double m_maxAngularVelocity;
+
+    // Encoder
+    int m_encoderTicksPerRevolution;
+    double m_rotation;
+
+};
+
+}
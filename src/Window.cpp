@@ -1,36 +1,43 @@
 #include "Window.h"
 
 #include <QAction>
+#include <QCheckBox>
 #include <QDebug>
 #include <QDoubleSpinBox>
+#include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QFrame>
 #include <QGroupBox>
 #include <QHBoxLayout>
+#include <QJsonDocument>
 #include <QLinkedList>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QPixmap>
 #include <QShortcut>
+#include <QSignalBlocker>
 #include <QSplitter>
+#include <QStandardPaths>
 #include <QTabWidget>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QtMath>
 
+#include <limits>
+
 #include "AssertMacros.h"
 #include "Color.h"
 #include "ColorManager.h"
 #include "ConfigDialog.h"
 #include "Dimensions.h"
-#include "FontImage.h"
 #include "ProcessUtilities.h"
 #include "SettingsMazeFiles.h"
 #include "SettingsMouseAlgos.h"
 #include "SettingsMisc.h"
 #include "SimUtilities.h"
+#include "TraceMacros.h"
 
 namespace mms {
 
@@ -45,10 +52,6 @@ const QString Window::FAILED_STYLE_SHEET =
 const QString Window::ERROR_STYLE_SHEET =
     "QLabel { background: rgb(230, 150, 230); }";
 
-const QString Window::ACK = "ack";
-const QString Window::CRASH = "crash";
-const QString Window::INVALID = "invalid";
-
 const int Window::SPEED_SLIDER_MAX = 99;
 const int Window::SPEED_SLIDER_DEFAULT = 33;
 const double Window::PROGRESS_REQUIRED_FOR_MOVE = 100.0;
@@ -56,6 +59,18 @@ const double Window::PROGRESS_REQUIRED_FOR_TURN = 33.33;
 const double Window::MIN_PROGRESS_PER_SECOND = 10.0;
 const double Window::MAX_PROGRESS_PER_SECOND = 5000.0;
 const double Window::MAX_SLEEP_SECONDS = 0.008;
+const QVector<Color> Window::MOUSE_BODY_COLORS = {
+    Color::BLUE,
+    Color::ORANGE,
+    Color::CYAN,
+    Color::YELLOW,
+    Color::DARK_VIOLET,
+    Color::WHITE,
+};
+const int Window::COMMANDS_PER_TURN = 256;
+const qint64 Window::SCHEDULER_SLICE_NANOSECONDS = 4000000;
+const double Window::MIN_REPLAY_SPEED = 0.25;
+const double Window::MAX_REPLAY_SPEED = 64.0;
 
 Window::Window(QWidget *parent) :
     QMainWindow(parent),
@@ -75,6 +90,7 @@ Window::Window(QWidget *parent) :
     m_mouseAlgoOutputTabWidget(new QTabWidget()),
     m_buildOutput(new QPlainTextEdit()),
     m_runOutput(new QPlainTextEdit()),
+    m_statsOutput(new QPlainTextEdit()),
 
     // Algo build
     m_buildButton(new QPushButton("Build")),
@@ -83,35 +99,30 @@ Window::Window(QWidget *parent) :
 
     // Algo run
     m_runButton(new QPushButton("Run")),
-    m_runProcess(nullptr),
+    m_addRunButton(new QPushButton("Add Mouse")),
     m_runStatus(new QLabel()),
-    m_mouse(nullptr),
-    m_view(nullptr),
-    m_mouseGraphic(nullptr),
+    m_runs(QVector<MouseRun*>()),
+    m_shownRun(0),
 
     // Pause/reset
     m_isPaused(false),
-    m_wasReset(false),
     m_pauseButton(new QPushButton("Pause")),
     m_resetButton(new QPushButton("Reset")),
 
     // Communication
-    m_logBuffer(QStringList()),
-    m_commandBuffer(QStringList()),
-    m_commandQueue(QQueue<QString>()),
-    m_commandQueueTimer(new QTimer()),
+    m_schedulerTimer(new QTimer()),
+    m_nextRun(0),
 
-    // Movement
-    m_startingLocation({0, 0}),
-    m_startingDirection(Direction::NORTH),
-    m_movement(Movement::NONE),
-    m_movementProgress(0.0),
-    m_movementStepSize(0.0),
-    m_speedSlider(new QSlider(Qt::Horizontal)),
+    // Stats
+    m_commandStats(),
 
-    // Helpers
-    m_tilesWithColor(QSet<QPair<int, int>>()),
-    m_tilesWithText(QSet<QPair<int, int>>()) {
+    // Replay
+    m_replay(nullptr),
+    m_replayButton(new QPushButton("Replay")),
+    m_replaySlider(new QSlider(Qt::Horizontal)),
+
+    // Movement
+    m_speedSlider(new QSlider(Qt::Horizontal)) {
 
     // Keyboard shortcuts for closing the window
     QShortcut* ctrl_q = new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_Q), this);
@@ -119,6 +130,21 @@ Window::Window(QWidget *parent) :
     connect(ctrl_q, &QShortcut::activated, this, &QMainWindow::close);
     connect(ctrl_w, &QShortcut::activated, this, &QMainWindow::close);
 
+    // Keyboard shortcut for writing a timeline of recent activity
+    QShortcut* ctrl_shift_t =
+        new QShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_T), this);
+    connect(ctrl_shift_t, &QShortcut::activated, this, &Window::writeTrace);
+
+    // Keyboard shortcut for showing the frame stats on top of the map
+    QShortcut* ctrl_shift_f =
+        new QShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_F), this);
+    connect(ctrl_shift_f, &QShortcut::activated, m_map, &Map::toggleFrameStats);
+
+    // Keyboard shortcut for showing the view of the next mouse
+    QShortcut* ctrl_shift_v =
+        new QShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_V), this);
+    connect(ctrl_shift_v, &QShortcut::activated, this, &Window::showNextRun);
+
     // Add the map and panel to the window
     QVBoxLayout* panelLayout = new QVBoxLayout();
     panelLayout->setContentsMargins(0, 6, 6, 6);
@@ -188,6 +214,23 @@ Window::Window(QWidget *parent) :
     m_speedSlider->setRange(0, SPEED_SLIDER_MAX);
     m_speedSlider->setValue(SPEED_SLIDER_DEFAULT);
 
+    // Add the button for adding mice to a run, only enabled while running
+    m_addRunButton->setEnabled(false);
+    controlsLayout->addWidget(m_addRunButton, 1, 4);
+    connect(m_addRunButton, &QPushButton::clicked, this, &Window::addRun);
+
+    // Add the replay button and the slider for seeking within the replay
+    controlsLayout->addWidget(m_replayButton, 2, 0);
+    controlsLayout->addWidget(m_replaySlider, 2, 1, 1, 3);
+    m_replaySlider->setEnabled(false);
+    connect(m_replayButton, &QPushButton::clicked, this, &Window::startReplay);
+    connect(
+        m_replaySlider,
+        &QSlider::valueChanged,
+        this,
+        &Window::onReplaySliderChanged
+    );
+
     // Add config box labels
     QLabel* mazeLabel = new QLabel("Maze");
     QLabel* mouseLabel = new QLabel("Mouse");
@@ -253,7 +296,8 @@ Window::Window(QWidget *parent) :
     panelLayout->addWidget(m_mouseAlgoOutputTabWidget);
     m_mouseAlgoOutputTabWidget->addTab(m_buildOutput, "Build Output");
     m_mouseAlgoOutputTabWidget->addTab(m_runOutput, "Run Output");
-    for (QPlainTextEdit* output : {m_buildOutput, m_runOutput}) {
+    m_mouseAlgoOutputTabWidget->addTab(m_statsOutput, "Stats");
+    for (QPlainTextEdit* output : {m_buildOutput, m_runOutput, m_statsOutput}) {
         output->setReadOnly(true);
         output->setLineWrapMode(QPlainTextEdit::NoWrap);
         QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
@@ -261,6 +305,16 @@ Window::Window(QWidget *parent) :
         output->document()->setDefaultFont(font);
     }
 
+    // The run output only keeps the most recent lines; the rest can be
+    // written to a file instead
+    m_runOutput->setMaximumBlockCount(RunLog::CAPACITY);
+    QCheckBox* runLogToFileCheckBox = new QCheckBox("Log to file");
+    runLogToFileCheckBox->setChecked(SettingsMisc::getRunLogToFile());
+    m_mouseAlgoOutputTabWidget->setCornerWidget(runLogToFileCheckBox);
+    connect(runLogToFileCheckBox, &QCheckBox::toggled, this, [](bool checked){
+        SettingsMisc::setRunLogToFile(checked);
+    });
+
     // Resize the window and make the map square
     int windowWidth = SettingsMisc::getRecentWindowWidth();
     int windowHeight = SettingsMisc::getRecentWindowHeight();
@@ -287,15 +341,20 @@ Window::Window(QWidget *parent) :
     // Add the mouse algos
     refreshMouseAlgoComboBox(SettingsMisc::getRecentMouseAlgo());
 
-    // Configure command queue timer
-    m_commandQueueTimer->setSingleShot(true);
+    // Configure the timer that continues dispatching commands
+    m_schedulerTimer->setSingleShot(true);
     connect(
-        m_commandQueueTimer,
+        m_schedulerTimer,
         &QTimer::timeout,
         this,
-        &Window::processQueuedCommands
+        &Window::dispatchPendingCommands
     );
 
+    // Refresh the stats while they're visible
+    QTimer* statsTimer = new QTimer();
+    connect(statsTimer, &QTimer::timeout, this, &Window::refreshStats);
+    statsTimer->start(500);
+
     // Start the graphics loop
     double secondsPerFrame = 1.0 / 60;
     QTimer* mapTimer = new QTimer();
@@ -308,6 +367,16 @@ Window::Window(QWidget *parent) :
             if (now - then < secondsPerFrame) {
                 return;
             }
+            advanceReplay(now - then);
+            advanceWorlds();
+            // Apply the latest visualization changes, once per tile per frame
+            if (m_truth != nullptr) {
+                m_truth->getMazeGraphic()->flush();
+            }
+            for (MouseRun* run : m_runs) {
+                run->getView()->getMazeGraphic()->flush();
+            }
+            flushRunLog();
             m_map->update();
             then = now;
         }
@@ -375,10 +444,20 @@ void Window::updateMazeAndPath(Maze* maze, QString path) {
     updateMaze(maze);
     m_currentMazeFile = path;
     SettingsMisc::setRecentMazeFile(path);
+
+    // Unofficial mazes can still be used, but it's worth knowing why
+    if (!m_maze->isOfficial()) {
+        m_runLog.append(QString("%1 isn't an official maze: it %2").arg(
+            path,
+            m_maze->getFailedOfficialChecks().join(", it ")
+        ));
+    }
 }
 
 void Window::updateMaze(Maze* maze) {
 
+    TRACE_SCOPE("Window::updateMaze");
+
     // Stop running maze/mouse algos
     cancelAllProcesses();
 
@@ -392,17 +471,17 @@ void Window::updateMaze(Maze* maze) {
     MazeGraphic* mazeGraphic = m_truth->getMazeGraphic();
     for (int x = 0; x < m_maze->getWidth(); x += 1) {
         for (int y = 0; y < m_maze->getHeight(); y += 1) {
-            const Tile* tile = m_maze->getTile(x, y);
             for (Direction d : DIRECTIONS()) {
-                if (tile->isWall(d)) {
+                if (m_maze->isWall(x, y, d)) {
                     mazeGraphic->setWall(x, y, d);
                 }
             }
-            int distance = tile->getDistance();
+            int distance = m_maze->getDistance(x, y);
             QString text = 0 <= distance ? QString::number(distance) : "inf";
             mazeGraphic->setText(x, y, text);
         }
     }
+    mazeGraphic->flush();
 
     // Update pointers held by other objects
     m_map->setMaze(m_maze);
@@ -414,13 +493,11 @@ void Window::updateMaze(Maze* maze) {
 }
 
 void Window::onMouseAlgoComboBoxChanged(QString name) {
-    cancelAllProcesses();
+    // Runs continue, so that mice with other algos can be added to them
+    cancelBuild();
     m_buildStatus->setText("");
     m_buildStatus->setStyleSheet("");
     m_buildOutput->clear();
-    m_runStatus->setText("");
-    m_runStatus->setStyleSheet("");
-    m_runOutput->clear();
     SettingsMisc::setRecentMouseAlgo(name);
 }
 
@@ -509,6 +586,7 @@ void Window::cancelProcess(QProcess* process, QLabel* status) {
 
 void Window::cancelAllProcesses() {
     cancelBuild();
+    stopReplay();
     cancelRun();
 }
 
@@ -649,11 +727,73 @@ void Window::onBuildExit(int exitCode, QProcess::ExitStatus exitStatus) {
 
 void Window::startRun() {
 
-    // Only one algo running at a time
-    ASSERT_TR(m_runProcess == nullptr);
+    // Only one run at a time, though it can have several mice
+    ASSERT_FA(isRunning());
+
+    // Clear the ouput and bring it to the front
+    removeMiceFromMaze();
+    m_runOutput->clear();
+    QString runLogPath;
+    if (SettingsMisc::getRunLogToFile()) {
+        runLogPath = getAppDataFilePath("run.log");
+    }
+    if (!m_runLog.start(runLogPath)) {
+        m_runLog.append("Couldn't write the run output to " + runLogPath);
+    }
+    m_mouseAlgoOutputTabWidget->setCurrentWidget(m_runOutput);
+    m_commandStats.reset();
+
+    MouseRun* run = startMouseRun(m_mouseAlgoComboBox->currentText());
+    if (run == nullptr) {
+        m_runLog.stop();
+        m_runStatus->setText("ERROR");
+        m_runStatus->setStyleSheet(ERROR_STYLE_SHEET);
+        return;
+    }
+
+    // Only the first mouse is recorded, and only once it has started, so that
+    // a run that fails to start doesn't overwrite the last recording. Its
+    // output isn't read until control returns to the event loop, so nothing
+    // is missed.
+    startRecording();
+    run->setIsRecorded(true);
+
+    // Update the run button
+    disconnect(
+        m_runButton,
+        &QPushButton::clicked,
+        this,
+        &Window::startRun
+    );
+    connect(
+        m_runButton,
+        &QPushButton::clicked,
+        this,
+        &Window::cancelRun
+    );
+    m_runButton->setText("Cancel");
+
+    // Update the run status
+    m_runStatus->setText("RUNNING");
+    m_runStatus->setStyleSheet(IN_PROGRESS_STYLE_SHEET);
+
+    // Only enabled while mouse is running
+    m_pauseButton->setEnabled(true);
+    m_resetButton->setEnabled(true);
+    m_addRunButton->setEnabled(true);
+    m_replayButton->setEnabled(false);
+}
+
+void Window::addRun() {
+    if (!isRunning()) {
+        return;
+    }
+    startMouseRun(m_mouseAlgoComboBox->currentText());
+}
+
+MouseRun* Window::startMouseRun(QString name) {
 
     // Extract the relevant config
-    QString name = m_mouseAlgoComboBox->currentText();
     QString directory = SettingsMouseAlgos::getDirectory(name);
     QString runCommand = SettingsMouseAlgos::getRunCommand(name);
 
@@ -666,7 +806,7 @@ void Window::startRun() {
                 name
             )
         );
-        return;
+        return nullptr;
     }
     if (runCommand.isEmpty()) {
         QMessageBox::warning(
@@ -676,37 +816,45 @@ void Window::startRun() {
                 name
             )
         );
-        return;
+        return nullptr;
     }
     ASSERT_FA(m_maze == nullptr);
 
-    // Remove the old mouse, add a new mouse
-    removeMouseFromMaze();
-    m_mouse = new Mouse();
-    m_view = new MazeView(m_maze);
-    m_mouseGraphic = new MouseGraphic(m_mouse);
-    m_map->setView(m_view);
-    m_map->setMouseGraphic(m_mouseGraphic);
+    // Mice with the same algo are told apart by number and by color
+    for (MouseRun* other : m_runs) {
+        if (other->getName() == name) {
+            QString number = QString::number(m_runs.size() + 1);
+            name = QString("%1 (%2)").arg(name, number);
+            break;
+        }
+    }
+    Color bodyColor = ColorManager::getMouseBodyColor();
+    if (!m_runs.isEmpty()) {
+        bodyColor = MOUSE_BODY_COLORS.at(
+            (m_runs.size() - 1) % MOUSE_BODY_COLORS.size());
+    }
+    MouseRun* run = new MouseRun(m_maze, name, bodyColor);
 
     // Instantiate a new process
     QProcess* process = new QProcess();
 
-    // Print stderr
+    // Print stderr, labeled by mouse once there's more than one
     connect(process, &QProcess::readyReadStandardError, this, [=](){
+        TRACE_SCOPE("Window::readStandardError");
         QString output = process->readAllStandardError();
-        QStringList logs = processText(output, &m_logBuffer);
-        for (QString log : logs) {
-            m_runOutput->appendPlainText(log);
+        QStringList lines = processText(output, run->getLogBuffer());
+        if (1 < m_runs.size()) {
+            for (QString& line : lines) {
+                line.prepend("[" + run->getName() + "] ");
+            }
         }
+        m_runLog.append(lines);
     });
 
     // Process commands from stdout
     connect(process, &QProcess::readyReadStandardOutput, this, [=](){
-        QString output = process->readAllStandardOutput();
-        QStringList commands = processText(output, &m_commandBuffer);
-        for (QString command : commands) {
-            dispatchCommand(command);
-        }
+        TRACE_SCOPE("Window::readStandardOutput");
+        processCommands(run, process->readAllStandardOutput());
     });
 
     // Clean up on exit
@@ -716,58 +864,86 @@ void Window::startRun() {
             &QProcess::finished
         ),
         this,
-        &Window::onRunExit
+        [=](int exitCode, QProcess::ExitStatus exitStatus){
+            onRunExit(run, exitCode, exitStatus);
+        }
     );
 
-    // Clear the ouput and bring it to the front
-    m_runOutput->clear();
-    m_mouseAlgoOutputTabWidget->setCurrentWidget(m_runOutput);
+    // Continue the movement of the mouse
+    connect(run->getCommandQueueTimer(), &QTimer::timeout, this, [=](){
+        processQueuedCommands(run);
+    });
 
     // Start the run process
-    if (ProcessUtilities::start(runCommand, directory, process)) {
-
-        // Save a pointer to the process
-        m_runProcess = process;
-
-        // Update the run button
-        disconnect(
-            m_runButton,
-            &QPushButton::clicked,
-            this,
-            &Window::startRun
-        );
-        connect(
-            m_runButton,
-            &QPushButton::clicked,
-            this,
-            &Window::cancelRun
-        );
-        m_runButton->setText("Cancel");
-
-        // Update the run status
-        m_runStatus->setText("RUNNING");
-        m_runStatus->setStyleSheet(IN_PROGRESS_STYLE_SHEET);
-
-        // Only enabled while mouse is running
-        m_pauseButton->setEnabled(true);
-        m_resetButton->setEnabled(true);
-    } 
-    else {
-        // Clean up the failed process
-        m_runOutput->appendPlainText(process->errorString());
-        m_runStatus->setText("ERROR");
-        m_runStatus->setStyleSheet(ERROR_STYLE_SHEET);
-        removeMouseFromMaze();
+    if (!ProcessUtilities::start(runCommand, directory, process)) {
+        m_runLog.append(process->errorString());
         delete process;
+        delete run;
+        return nullptr;
+    }
+    run->setProcess(process);
+    m_runs.append(run);
+    updateMapMice();
+    if (1 < m_runs.size()) {
+        m_runLog.append("Added " + run->getName());
+    }
+    return run;
+}
+
+bool Window::isRunning() const {
+    for (MouseRun* run : m_runs) {
+        if (run->getProcess() != nullptr) {
+            return true;
+        }
     }
+    return false;
 }
 
 void Window::cancelRun() {
-    cancelProcess(m_runProcess, m_runStatus);
-    removeMouseFromMaze();
+    // Copy the runs, since each exit updates the window
+    QVector<MouseRun*> runs = m_runs;
+    for (MouseRun* run : runs) {
+        cancelProcess(run->getProcess(), m_runStatus);
+    }
+    removeMiceFromMaze();
 }
 
-void Window::onRunExit(int exitCode, QProcess::ExitStatus exitStatus) {
+void Window::onRunExit(
+        MouseRun* run,
+        int exitCode,
+        QProcess::ExitStatus exitStatus) {
+
+    // Clean up (stop producing commands)
+    run->setHasFailed(!(exitStatus == QProcess::NormalExit && exitCode == 0));
+    run->deleteProcess();
+
+    // The last of the output may still be waiting for the scheduler; without
+    // the process, only the commands without a response are performed
+    dispatchCommands(run, std::numeric_limits<int>::max());
+
+    if (1 < m_runs.size()) {
+        m_runLog.append(QString("%1 %2").arg(
+            run->getName(),
+            run->hasFailed() ? "failed" : "completed"
+        ));
+    }
+
+    // Stop consuming queued commands
+    run->clearCommandQueue();
+    run->clearOutput();
+    run->setWasReset(false);
+    if (run->isRecorded()) {
+        stopRecording();
+    }
+
+    // Nothing can steer the mouse anymore, so leave it where it is and stop
+    // simulating it
+    run->stopWorld();
+
+    // The rest only happens once every mouse is done
+    if (isRunning()) {
+        return;
+    }
 
     // Always unpause on exit
     if (m_isPaused) {
@@ -778,7 +954,8 @@ void Window::onRunExit(int exitCode, QProcess::ExitStatus exitStatus) {
     m_pauseButton->setEnabled(false);
     m_resetButton->setEnabled(false);
     m_resetButton->setText("Reset");
-    m_wasReset = false;
+    m_addRunButton->setEnabled(false);
+    m_replayButton->setEnabled(true);
 
     // Update the run button
     disconnect(
@@ -796,7 +973,11 @@ void Window::onRunExit(int exitCode, QProcess::ExitStatus exitStatus) {
     m_runButton->setText("Run");
 
     // Update the status label
-    if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+    bool hasFailed = false;
+    for (MouseRun* other : m_runs) {
+        hasFailed = hasFailed || other->hasFailed();
+    }
+    if (!hasFailed) {
         m_runStatus->setText("COMPLETE");
         m_runStatus->setStyleSheet(COMPLETE_STYLE_SHEET);
     }
@@ -805,50 +986,52 @@ void Window::onRunExit(int exitCode, QProcess::ExitStatus exitStatus) {
         m_runStatus->setStyleSheet(FAILED_STYLE_SHEET);
     }
 
-    // Clean up (stop producing commands)
-    delete m_runProcess;
-    m_runProcess = nullptr;
+    // Save the stats and output for this run
+    refreshStats();
+    writeStats();
+    m_runLog.stop();
+}
 
-    // Stop consuming queued commands
-    m_commandQueueTimer->stop();
-    m_commandQueue.clear();
+void Window::showNextRun() {
+    if (m_runs.size() < 2) {
+        return;
+    }
+    m_shownRun = (m_shownRun + 1) % m_runs.size();
+    updateMapMice();
+    m_runLog.append("Showing the view of " + m_runs.at(m_shownRun)->getName());
+}
+
+void Window::updateMapMice() {
+    if (m_runs.isEmpty()) {
+        m_map->setMouseGraphics({});
+        m_map->setView(m_truth);
+        return;
+    }
+    QVector<const MouseGraphic*> mouseGraphics;
+    for (MouseRun* run : m_runs) {
+        mouseGraphics.append(run->getMouseGraphic());
+    }
+    m_map->setView(m_runs.at(m_shownRun)->getView());
+    m_map->setMouseGraphics(mouseGraphics);
 }
 
-void Window::removeMouseFromMaze() {
+void Window::removeMiceFromMaze() {
 
-    // No-op if no mouse
-    if (m_mouse == nullptr) {
+    // No-op if no mice
+    if (m_runs.isEmpty()) {
         return;
     }
 
-    // Update some objects
-    m_map->setView(m_truth);
-    m_map->setMouseGraphic(nullptr);
-
-    // Delete some objects
-    ASSERT_FA(m_view == nullptr);
-    ASSERT_FA(m_mouseGraphic == nullptr);
-    delete m_mouse;
-    m_mouse = nullptr;
-    delete m_view;
-    m_view = nullptr;
-    delete m_mouseGraphic;
-    m_mouseGraphic = nullptr;
-
-    // Reset communication state
-    m_logBuffer.clear();
-    m_commandBuffer.clear();
-
-    // Reset movement state
-    m_startingLocation = {0, 0};
-    m_startingDirection = Direction::NORTH;
-    m_movement = Movement::NONE;
-    m_movementProgress = 0.0;
-    m_movementStepSize = 0.0;
-
-    // Reset other mouse state
-    m_tilesWithColor.clear();
-    m_tilesWithText.clear();
+    // Update some objects before deleting the mice
+    QVector<MouseRun*> runs;
+    runs.swap(m_runs);
+    m_shownRun = 0;
+    m_nextRun = 0;
+    m_schedulerTimer->stop();
+    updateMapMice();
+    for (MouseRun* run : runs) {
+        delete run;
+    }
 }
 
 void Window::onPauseButtonPressed() {
@@ -860,14 +1043,20 @@ void Window::onPauseButtonPressed() {
     else {
         m_pauseButton->setText("Pause");
         m_runStatus->setText("RUNNING");
-        processQueuedCommands();
+        for (MouseRun* run : m_runs) {
+            if (!run->getCommandQueueTimer()->isActive()) {
+                processQueuedCommands(run);
+            }
+        }
     }
 }
 
 void Window::onResetButtonPressed() {
     m_resetButton->setEnabled(false);
     m_resetButton->setText("Waiting");
-    m_wasReset = true;
+    for (MouseRun* run : m_runs) {
+        run->setWasReset(run->getProcess() != nullptr);
+    }
 }
 
 QStringList Window::processText(QString text, QStringList* buffer) {
@@ -898,218 +1087,328 @@ QStringList Window::processText(QString text, QStringList* buffer) {
     return lines;
 }
 
-void Window::dispatchCommand(QString command) {
+void Window::processCommands(MouseRun* run, const QByteArray& output) {
 
-    // For performance reasons, handle no-response commands inline (don't queue
-    // them with the commands that elicit a response, just perform the action)
-    if (
-        command.startsWith("setWall") ||
-        command.startsWith("clearWall")
-    ) {
-        QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-        if (tokens.size() != 4) {
-            return;
-        }
-        if (!(tokens.at(0) == "setWall" || tokens.at(0) == "clearWall")) {
-            return;
-        }
-        bool ok = true;
-        int x = tokens.at(1).toInt(&ok);
-        int y = tokens.at(2).toInt(&ok);
-        if (!ok) {
-            return;
-        }
-        if (tokens.at(3).size() != 1) {
-            return;
-        }
-        QChar direction = tokens.at(3).at(0);
-        if (!CHAR_TO_DIRECTION().contains(direction)) {
-            return;
-        }
-        if (command.startsWith("setWall")) {
-            setWall(x, y, direction);
-        }
-        else if (command.startsWith("clearWall")) {
-            clearWall(x, y, direction);
-        }
-        else {
-            ASSERT_NEVER_RUNS();
-        }
+    run->appendOutput(output, CommandStats::now());
+    if (!m_schedulerTimer->isActive()) {
+        dispatchPendingCommands();
     }
-    else if (command.startsWith("setColor")) {
-        QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-        if (tokens.size() != 4) {
-            return;
-        }
-        if (tokens.at(0) != "setColor") {
-            return;
-        }
-        bool ok = true;
-        int x = tokens.at(1).toInt(&ok);
-        int y = tokens.at(2).toInt(&ok);
-        if (!ok) {
-            return;
-        }
-        if (tokens.at(3).size() != 1) {
-            return;
+}
+
+void Window::dispatchPendingCommands() {
+
+    TRACE_SCOPE("Window::dispatchPendingCommands");
+
+    // Round robin, starting after the run that went first last time
+    qint64 deadline = CommandStats::now() + SCHEDULER_SLICE_NANOSECONDS;
+    bool isPending = true;
+    while (isPending && !m_runs.isEmpty()) {
+        isPending = false;
+        for (int i = 0; i < m_runs.size(); i += 1) {
+            MouseRun* run = m_runs.at((m_nextRun + i) % m_runs.size());
+            int count = dispatchCommands(run, COMMANDS_PER_TURN);
+            if (count == COMMANDS_PER_TURN && run->hasPendingCommands()) {
+                isPending = true;
+            }
         }
-        QChar color = tokens.at(3).at(0);
-        if (!CHAR_TO_COLOR().contains(color)) {
-            return;
+        m_nextRun = (m_nextRun + 1) % m_runs.size();
+        if (isPending && deadline < CommandStats::now()) {
+            // Let the event loop read output and draw frames
+            m_schedulerTimer->start(0);
+            break;
         }
-        setColor(x, y, color);
     }
-    else if (command.startsWith("clearColor")) {
-        QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-        if (tokens.size() != 3) {
-            return;
-        }
-        if (tokens.at(0) != "clearColor") {
-            return;
-        }
-        bool ok = true;
-        int x = tokens.at(1).toInt(&ok);
-        int y = tokens.at(2).toInt(&ok);
-        if (!ok) {
-            return;
-        }
-        clearColor(x, y);
+}
+
+int Window::dispatchCommands(MouseRun* run, int maxCommands) {
+
+    const char* line = nullptr;
+    int length = 0;
+    int count = 0;
+    while (count < maxCommands && run->takeCommandLine(&line, &length)) {
+        dispatchCommand(run, line, length);
+        count += 1;
     }
-    else if (command.startsWith("clearAllColor")) {
-        QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-        if (tokens.size() != 1) {
-            return;
+    run->compactOutput();
+    return count;
+}
+
+void Window::dispatchCommand(MouseRun* run, const char* line, int length) {
+
+    qint64 start = CommandStats::now();
+    Command command = CommandParser::parse(line, length);
+    m_commandStats.record(
+        command.type,
+        CommandStage::ARRIVAL,
+        start - run->getOutputArrivalTime()
+    );
+    if (run->isRecorded()) {
+        m_runRecorder.recordCommand(command, start);
+    }
+
+    // Drop all invalid commands on the floor
+    if (command.type == CommandType::INVALID) {
+        m_commandStats.record(
+            command.type, CommandStage::HANDLER, CommandStats::now() - start);
+        return;
+    }
+
+    // For performance reasons, handle no-response commands inline (don't queue
+    // them with the commands that elicit a response, just perform the action)
+    if (CommandParser::isInline(command.type)) {
+        executeCommand(run, command);
+        m_commandStats.record(
+            command.type, CommandStage::HANDLER, CommandStats::now() - start);
+        return;
+    }
+
+    // An algorithm that has exited isn't waiting for any more responses
+    if (run->getProcess() == nullptr) {
+        return;
+    }
+
+    // Enqueue the serial command, process it if
+    // future processing is not already scheduled
+    run->enqueueCommand(command, start);
+    if (!run->getCommandQueueTimer()->isActive()) {
+        processQueuedCommands(run);
+    }
+}
+
+QString Window::executeCommand(MouseRun* run, const Command& command) {
+    RunMouse mouse(this, run);
+    return CommandDispatcher::execute(&mouse, command);
+}
+
+void Window::processQueuedCommands(MouseRun* run) {
+    TRACE_SCOPE("Window::processQueuedCommands");
+    while (run->hasQueuedCommands() && !m_isPaused) {
+        QString response = "";
+        CommandType type = run->getQueuedCommand().type;
+        if (isMoving(run)) {
+            updateMouseProgress(run, run->getMovementStepSize());
+            if (!isMoving(run)) {
+                m_commandStats.record(
+                    type,
+                    CommandStage::ANIMATION,
+                    CommandStats::now() - run->getMovementStartTime()
+                );
+                response = CommandDispatcher::ACK;
+            }
         }
-        if (tokens.at(0) != "clearAllColor") {
-            return;
+        else {
+            qint64 start = CommandStats::now();
+            m_commandStats.record(
+                type,
+                CommandStage::QUEUE,
+                start - run->getQueuedCommandTime()
+            );
+            response = executeCommand(run, run->getQueuedCommand());
+            qint64 end = CommandStats::now();
+            m_commandStats.record(type, CommandStage::HANDLER, end - start);
+            run->setMovementStartTime(end);
         }
-        clearAllColor();
-    }
-    else if (command.startsWith("setText")) {
-        // Special parsing to allow space characters in the text
-        int firstSpace = command.indexOf(" ");
-        int secondSpace = command.indexOf(" ", firstSpace + 1);
-        int thirdSpace = command.indexOf(" ", secondSpace + 1);
-        QString function = command.left(firstSpace);
-        if (function != "setText") {
-            return;
+        if (!response.isEmpty()) {
+            if (run->isRecorded()) {
+                m_runRecorder.recordResponse(response, CommandStats::now());
+            }
+            // Drop all invalid commands on the floor
+            if (response != CommandDispatcher::INVALID) {
+                TRACE_SCOPE("QProcess::write");
+                qint64 start = CommandStats::now();
+                run->getProcess()->write(
+                    (response + "\n").toStdString().c_str());
+                m_commandStats.record(
+                    type,
+                    CommandStage::RESPONSE,
+                    CommandStats::now() - start
+                );
+            }
+            run->dequeueCommand();
         }
-        QString xString = command.mid(firstSpace + 1, secondSpace - firstSpace);
-        QString yString = command.mid(secondSpace + 1, thirdSpace - secondSpace);
-        bool ok = true;
-        int x = xString.toInt(&ok);
-        int y = yString.toInt(&ok);
-        if (!ok) {
-            return;
+        else {
+            scheduleMouseProgressUpdate(run);
+            break;
         }
-        QString text = command.mid(thirdSpace + 1);
-        setText(x, y, text);
     }
-    else if (command.startsWith("clearText")) {
-        QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-        if (tokens.size() != 3) {
-            return;
-        }
-        if (tokens.at(0) != "clearText") {
-            return;
-        }
-        bool ok = true;
-        int x = tokens.at(1).toInt(&ok);
-        int y = tokens.at(2).toInt(&ok);
-        if (!ok) {
-            return;
-        }
-        clearText(x, y);
+}
+
+void Window::flushRunLog() {
+    int dropped = 0;
+    QStringList lines = m_runLog.take(&dropped);
+    if (lines.isEmpty()) {
+        return;
     }
-    else if (command.startsWith("clearAllText")) {
-        QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-        if (tokens.size() != 1) {
-            return;
-        }
-        if (tokens.at(0) != "clearAllText") {
-            return;
-        }
-        clearAllText();
+    TRACE_SCOPE("Window::flushRunLog");
+    if (0 < dropped) {
+        lines.prepend(QString("[%1 lines not shown]").arg(dropped));
     }
-    else {
-        // Enqueue the serial command, process it if
-        // future processing is not already scheduled
-        m_commandQueue.enqueue(command);
-        if (!m_commandQueueTimer->isActive()) {
-            processQueuedCommands();
-        }
+    // A single append lays out the whole batch at once
+    m_runOutput->appendPlainText(lines.join("\n"));
+}
+
+void Window::refreshStats() {
+    if (m_mouseAlgoOutputTabWidget->currentWidget() != m_statsOutput) {
+        return;
     }
+    m_statsOutput->setPlainText(m_commandStats.toText());
 }
 
-QString Window::executeCommand(QString command) {
-    QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-    if (tokens.size() != 1) {
-        return INVALID;
+void Window::writeStats() {
+    QString path = getAppDataFilePath("stats.json");
+    if (path.isEmpty()) {
+        return;
     }
-    QString function = tokens.at(0);
-    if (function == "mazeWidth") {
-        return QString::number(mazeWidth());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
     }
-    else if (function == "mazeHeight") {
-        return QString::number(mazeHeight());
+    file.write(QJsonDocument(m_commandStats.toJson()).toJson());
+    m_runLog.append("Command stats written to " + path);
+}
+
+void Window::startRecording() {
+    QString path = getAppDataFilePath("run.mmsr");
+    if (path.isEmpty()) {
+        return;
     }
-    else if (function == "wallFront") {
-        return boolToString(wallFront());
+    if (!m_runRecorder.start(
+            path,
+            m_currentMazeFile,
+            m_maze->getWidth(),
+            m_maze->getHeight())) {
+        m_runLog.append("Couldn't record the run to " + path);
     }
-    else if (function == "wallRight") {
-        return boolToString(wallRight());
+}
+
+void Window::stopRecording() {
+    if (!m_runRecorder.isRecording()) {
+        return;
     }
-    else if (function == "wallLeft") {
-        return boolToString(wallLeft());
+    m_runRecorder.stop();
+    m_runLog.append("Run recorded to " + getAppDataFilePath("run.mmsr"));
+}
+
+void Window::startReplay() {
+
+    // Replays use the mouse and view of a run
+    if (isRunning()) {
+        return;
     }
-    else if (function == "moveForward") {
-        bool success = moveForward();
-        return success ? "" : CRASH;
+    QString path = getAppDataFilePath("run.mmsr");
+    RunReplay* replay = RunReplay::fromFile(path, m_maze);
+    if (replay == nullptr) {
+        QMessageBox::warning(
+            this,
+            "Invalid Recording",
+            QString(
+                "Couldn't replay \"%1\": it doesn't exist, isn't a valid "
+                "recording, or was recorded in a maze of a different size."
+            ).arg(path)
+        );
+        return;
     }
-    else if (function == "turnRight") {
-        turnRight();
-        return "";
+
+    // Remove the old mice, add a mouse without a process
+    removeMiceFromMaze();
+    MouseRun* run = new MouseRun(
+        m_maze, "replay", ColorManager::getMouseBodyColor());
+    m_runs.append(run);
+    updateMapMice();
+    m_replay = replay;
+    m_replay->attach(run->getView()->getMazeGraphic(), run->getMouse());
+
+    m_runOutput->clear();
+    m_mouseAlgoOutputTabWidget->setCurrentWidget(m_runOutput);
+    if (m_replay->getMazeFile() != m_currentMazeFile) {
+        m_runLog.append(
+            "The recording was made in " + m_replay->getMazeFile() +
+            ", so the replay may differ from the run"
+        );
     }
-    else if (function == "turnLeft") {
-        turnLeft();
-        return "";
+    m_runLog.append(QString("Replaying %1 commands from %2").arg(
+        QString::number(m_replay->getNumCommands()),
+        path
+    ));
+
+    // Update the buttons, status, and slider
+    disconnect(
+        m_replayButton,
+        &QPushButton::clicked,
+        this,
+        &Window::startReplay
+    );
+    connect(
+        m_replayButton,
+        &QPushButton::clicked,
+        this,
+        &Window::stopReplay
+    );
+    m_replayButton->setText("Stop");
+    m_runButton->setEnabled(false);
+    m_runStatus->setText("REPLAYING");
+    m_runStatus->setStyleSheet(IN_PROGRESS_STYLE_SHEET);
+    QSignalBlocker blocker(m_replaySlider);
+    m_replaySlider->setRange(0, m_replay->getNumCommands());
+    m_replaySlider->setValue(0);
+    m_replaySlider->setEnabled(true);
+}
+
+void Window::stopReplay() {
+    if (m_replay == nullptr) {
+        return;
     }
-    else if (function == "wasReset") {
-        return boolToString(wasReset());
+    delete m_replay;
+    m_replay = nullptr;
+    removeMiceFromMaze();
+
+    disconnect(
+        m_replayButton,
+        &QPushButton::clicked,
+        this,
+        &Window::stopReplay
+    );
+    connect(
+        m_replayButton,
+        &QPushButton::clicked,
+        this,
+        &Window::startReplay
+    );
+    m_replayButton->setText("Replay");
+    m_runButton->setEnabled(true);
+    m_runStatus->setText("");
+    m_runStatus->setStyleSheet("");
+    QSignalBlocker blocker(m_replaySlider);
+    m_replaySlider->setValue(0);
+    m_replaySlider->setEnabled(false);
+}
+
+void Window::advanceReplay(double seconds) {
+
+    // Don't fight the user for the slider
+    if (m_replay == nullptr || m_replaySlider->isSliderDown()) {
+        return;
     }
-    else if (function == "ackReset") {
-        ackReset();
-        return ACK;
+
+    if (!m_replay->isFinished()) {
+        m_replay->advance(seconds, getTimeScale());
+        QSignalBlocker blocker(m_replaySlider);
+        m_replaySlider->setValue(m_replay->getPosition());
     }
-    else {
-        return INVALID;
+}
+
+void Window::onReplaySliderChanged(int position) {
+    if (m_replay != nullptr) {
+        m_replay->seek(position);
     }
 }
 
-void Window::processQueuedCommands() {
-    while (!m_commandQueue.isEmpty() && !m_isPaused) {
-        QString response = "";
-        if (isMoving()) {
-            updateMouseProgress(m_movementStepSize);
-            if (!isMoving()) {
-                response = ACK;
-            }
-        }
-        else {
-            response = executeCommand(m_commandQueue.head());
-        }
-        if (!response.isEmpty()) {
-            // Drop all invalid commands on the floor
-            if (response != INVALID) {
-                m_runProcess->write((response + "\n").toStdString().c_str());
-            }
-            m_commandQueue.dequeue();
-        }
-        else {
-            scheduleMouseProgressUpdate();
-            break;
-        }
+void Window::writeTrace() {
+    QString path = getAppDataFilePath("trace.json");
+    if (path.isEmpty() || !Trace::write(path)) {
+        return;
     }
+    m_runLog.append("Trace written to " + path);
 }
 
 double Window::progressRequired(Movement movement) {
@@ -1124,23 +1423,25 @@ double Window::progressRequired(Movement movement) {
     }
 }
 
-void Window::updateMouseProgress(double progress) {
+void Window::updateMouseProgress(MouseRun* run, double progress) {
+
+    TRACE_SCOPE("Window::updateMouseProgress");
 
     // Determine the destination of the mouse.
-    QPair<int, int> destinationLocation = m_startingLocation;
+    QPair<int, int> destinationLocation = run->getStartingLocation();
     Angle destinationRotation =
-        DIRECTION_TO_ANGLE().value(m_startingDirection);
-    if (m_movement == Movement::MOVE_FORWARD) {
-        if (m_startingDirection == Direction::NORTH) {
+        DIRECTION_TO_ANGLE().value(run->getStartingDirection());
+    if (run->getMovement() == Movement::MOVE_FORWARD) {
+        if (run->getStartingDirection() == Direction::NORTH) {
             destinationLocation.second += 1;
         }
-        else if (m_startingDirection == Direction::EAST) {
+        else if (run->getStartingDirection() == Direction::EAST) {
             destinationLocation.first += 1;
         }
-        else if (m_startingDirection == Direction::SOUTH) {
+        else if (run->getStartingDirection() == Direction::SOUTH) {
             destinationLocation.second -= 1;
         }
-        else if (m_startingDirection == Direction::WEST) {
+        else if (run->getStartingDirection() == Direction::WEST) {
             destinationLocation.first -= 1;
         }
         else {
@@ -1150,10 +1451,10 @@ void Window::updateMouseProgress(double progress) {
     // Explicity add or subtract 90 degrees so that the mouse is guaranteed to
     // only rotate 90 degrees (using DIRECTION_ROTATE can cause the mouse to
     // rotate 270 degrees in the opposite direction in some cases)
-    else if (m_movement == Movement::TURN_RIGHT) {
+    else if (run->getMovement() == Movement::TURN_RIGHT) {
         destinationRotation -= Angle::Degrees(90);
     }
-    else if (m_movement == Movement::TURN_LEFT) {
+    else if (run->getMovement() == Movement::TURN_LEFT) {
         destinationRotation += Angle::Degrees(90);
     }
     else {
@@ -1161,21 +1462,22 @@ void Window::updateMouseProgress(double progress) {
     }
 
     // Increment the movement progress, calculate fraction complete
-    m_movementProgress += progress;
-    double required = progressRequired(m_movement);
-    double remaining = required - m_movementProgress;
+    run->addMovementProgress(progress);
+    double required = progressRequired(run->getMovement());
+    double remaining = required - run->getMovementProgress();
     if (remaining < 0) {
         remaining = 0;
     }
     double fraction = 1.0 - (remaining / required);
 
     // Calculate the current translation and rotation
+    QPair<int, int> startingLocation = run->getStartingLocation();
     Coordinate startingTranslation =
-        getCenterOfTile(m_startingLocation.first, m_startingLocation.second);
+        getCenterOfTile(startingLocation.first, startingLocation.second);
     Coordinate destinationTranslation =
         getCenterOfTile(destinationLocation.first, destinationLocation.second);
     Angle startingRotation =
-        DIRECTION_TO_ANGLE().value(m_startingDirection);
+        DIRECTION_TO_ANGLE().value(run->getStartingDirection());
     Coordinate currentTranslation =
         startingTranslation * (1.0 - fraction) +
         destinationTranslation * fraction;
@@ -1184,21 +1486,17 @@ void Window::updateMouseProgress(double progress) {
         destinationRotation * fraction;
 
     // Teleport the mouse, reset movement state if done
-    m_mouse->teleport(currentTranslation, currentRotation);
+    run->getMouse()->teleport(currentTranslation, currentRotation);
     if (remaining == 0.0) {
-        m_startingLocation = m_mouse->getCurrentDiscretizedTranslation();
-        m_startingDirection = m_mouse->getCurrentDiscretizedRotation();
-        m_movement = Movement::NONE;
-        m_movementProgress = 0.0;
-        m_movementStepSize = 0.0;
+        run->finishMovement();
     }
 }
 
-void Window::scheduleMouseProgressUpdate() {
+void Window::scheduleMouseProgressUpdate(MouseRun* run) {
     
     // Calculate progressRemaining, should be nonzero
-    double required = progressRequired(m_movement);
-    double progressRemaining = required - m_movementProgress;
+    double required = progressRequired(run->getMovement());
+    double progressRemaining = required - run->getMovementProgress();
     ASSERT_LT(0.0, progressRemaining);
 
     // Calculate progressPerSecond for non-linear slider
@@ -1217,12 +1515,44 @@ void Window::scheduleMouseProgressUpdate() {
     }
 
     // Update step size, set the timer
-    m_movementStepSize = progressRemaining;
-    m_commandQueueTimer->start(secondsRemaining * 1000);
+    run->setMovementStepSize(progressRemaining);
+    run->getCommandQueueTimer()->start(secondsRemaining * 1000);
+}
+
+bool Window::isMoving(MouseRun* run) {
+    return run->getMovement() != Movement::NONE;
 }
 
-bool Window::isMoving() {
-    return m_movement != Movement::NONE;
+double Window::getTimeScale() const {
+    // The speed slider scales time exponentially, from the minimum to the
+    // maximum replay speed, and then to as fast as possible, which is the
+    // MAX_SPEED of both replays and worlds
+    if (m_speedSlider->value() == SPEED_SLIDER_MAX) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double fraction =
+        static_cast<double>(m_speedSlider->value()) / SPEED_SLIDER_MAX;
+    return MIN_REPLAY_SPEED *
+        qPow(MAX_REPLAY_SPEED / MIN_REPLAY_SPEED, fraction);
+}
+
+void Window::advanceWorlds() {
+    double timeScale = getTimeScale();
+    for (MouseRun* run : m_runs) {
+        if (run->getWorld() == nullptr) {
+            continue;
+        }
+        run->getWorld()->setSpeed(timeScale);
+        run->getWorld()->setPaused(m_isPaused);
+        Coordinate translation;
+        Angle rotation;
+        run->getWorld()->getPose(&translation, &rotation);
+        run->getMouse()->teleport(translation, rotation);
+        if (run->getWorld()->isCrashed() && !run->hasCrashed()) {
+            run->setHasCrashed(true);
+            m_runLog.append(run->getName() + " crashed");
+        }
+    }
 }
 
 int Window::mazeWidth() {
@@ -1233,43 +1563,94 @@ int Window::mazeHeight() {
     return m_maze->getHeight();
 }
 
-bool Window::wallFront() {
-    QPair<int, int> position = m_mouse->getCurrentDiscretizedTranslation();
-    Direction direction = m_mouse->getCurrentDiscretizedRotation();
+bool Window::wallFront(MouseRun* run) {
+    Mouse* mouse = run->getMouse();
+    QPair<int, int> position = mouse->getCurrentDiscretizedTranslation();
+    Direction direction = mouse->getCurrentDiscretizedRotation();
     return isWall({position.first, position.second, direction});
 }
 
-bool Window::wallRight() {
-    QPair<int, int> position = m_mouse->getCurrentDiscretizedTranslation();
+bool Window::wallRight(MouseRun* run) {
+    Mouse* mouse = run->getMouse();
+    QPair<int, int> position = mouse->getCurrentDiscretizedTranslation();
     Direction direction =
-        DIRECTION_ROTATE_RIGHT().value(m_mouse->getCurrentDiscretizedRotation());
+        DIRECTION_ROTATE_RIGHT().value(mouse->getCurrentDiscretizedRotation());
     return isWall({position.first, position.second, direction});
 }
 
-bool Window::wallLeft() {
-    QPair<int, int> position = m_mouse->getCurrentDiscretizedTranslation();
+bool Window::wallLeft(MouseRun* run) {
+    Mouse* mouse = run->getMouse();
+    QPair<int, int> position = mouse->getCurrentDiscretizedTranslation();
     Direction direction =
-        DIRECTION_ROTATE_LEFT().value(m_mouse->getCurrentDiscretizedRotation());
+        DIRECTION_ROTATE_LEFT().value(mouse->getCurrentDiscretizedRotation());
     return isWall({position.first, position.second, direction});
 }
 
-bool Window::moveForward() {
-    if (wallFront()) {
-        return false;
+QString Window::moveForward(MouseRun* run) {
+    // A mouse on wheels can't also move a tile at a time
+    if (run->getWorld() != nullptr) {
+        return CommandDispatcher::ON_WHEELS;
     }
-    m_movement = Movement::MOVE_FORWARD;
-    return true;
+    if (wallFront(run)) {
+        return CommandDispatcher::CRASH;
+    }
+    run->setMovement(Movement::MOVE_FORWARD);
+    return QString();
+}
+
+QString Window::turnRight(MouseRun* run) {
+    if (run->getWorld() != nullptr) {
+        return CommandDispatcher::ON_WHEELS;
+    }
+    run->setMovement(Movement::TURN_RIGHT);
+    return QString();
+}
+
+QString Window::turnLeft(MouseRun* run) {
+    if (run->getWorld() != nullptr) {
+        return CommandDispatcher::ON_WHEELS;
+    }
+    run->setMovement(Movement::TURN_LEFT);
+    return QString();
 }
 
-void Window::turnRight() {
-    m_movement = Movement::TURN_RIGHT;
+void Window::setWheelSpeeds(MouseRun* run, int left, int right) {
+    // The world can't take over halfway through a tile, and the animation
+    // and the world would both move the mouse, so the speeds of a mouse that
+    // hasn't finished its movement are dropped
+    if (isMoving(run)) {
+        return;
+    }
+
+    // The world starts with the first command, so a discrete algorithm never
+    // pays for it
+    World* world = run->getWorld();
+    if (world == nullptr) {
+        world = run->startWorld();
+        world->setSpeed(getTimeScale());
+        world->setPaused(m_isPaused);
+    }
+    world->setWheelSpeeds(
+        Angle::Degrees(left).getRadiansUnbounded(),
+        Angle::Degrees(right).getRadiansUnbounded());
 }
 
-void Window::turnLeft() {
-    m_movement = Movement::TURN_LEFT;
+QPair<int, int> Window::readEncoders(MouseRun* run) {
+    if (run->getWorld() == nullptr) {
+        return {0, 0};
+    }
+    return run->getWorld()->readEncoders();
 }
 
-void Window::setWall(int x, int y, QChar direction) {
+QVector<double> Window::readSensors(MouseRun* run) {
+    // Until the mouse moves on its wheels, it's as if it saw nothing
+    if (run->getWorld() == nullptr) {
+        return QVector<double>(World::NUM_SENSORS, 0.0);
+    }
+    return run->getWorld()->readSensors();
+}
+
+void Window::setWall(MouseRun* run, int x, int y, QChar direction) {
     if (!isWithinMaze(x, y)) {
         return;
     }
@@ -1277,10 +1658,10 @@ void Window::setWall(int x, int y, QChar direction) {
         return;
     }
     Direction d = CHAR_TO_DIRECTION().value(direction);
-    m_view->getMazeGraphic()->setWall(x, y, d);
+    run->getView()->getMazeGraphic()->setWall(x, y, d);
     Wall opposingWall = getOpposingWall({x, y, d});
     if (isWithinMaze(opposingWall.x, opposingWall.y)) {
-        m_view->getMazeGraphic()->setWall(
+        run->getView()->getMazeGraphic()->setWall(
             opposingWall.x,
             opposingWall.y,
             opposingWall.d
@@ -1288,7 +1669,7 @@ void Window::setWall(int x, int y, QChar direction) {
     }
 }
 
-void Window::clearWall(int x, int y, QChar direction) {
+void Window::clearWall(MouseRun* run, int x, int y, QChar direction) {
     if (!isWithinMaze(x, y)) {
         return;
     }
@@ -1296,10 +1677,10 @@ void Window::clearWall(int x, int y, QChar direction) {
         return;
     }
     Direction d = CHAR_TO_DIRECTION().value(direction);
-    m_view->getMazeGraphic()->clearWall(x, y, d);
+    run->getView()->getMazeGraphic()->clearWall(x, y, d);
     Wall opposingWall = getOpposingWall({x, y, d});
     if (isWithinMaze(opposingWall.x, opposingWall.y)) {
-        m_view->getMazeGraphic()->clearWall(
+        run->getView()->getMazeGraphic()->clearWall(
             opposingWall.x,
             opposingWall.y,
             opposingWall.d
@@ -1307,81 +1688,162 @@ void Window::clearWall(int x, int y, QChar direction) {
     }
 }
 
-void Window::setColor(int x, int y, QChar color) {
+void Window::setColor(MouseRun* run, int x, int y, QChar color) {
     if (!isWithinMaze(x, y)) {
         return;
     }
     if (!CHAR_TO_COLOR().contains(color)) {
         return;
     }
-    m_view->getMazeGraphic()->setColor(x, y, CHAR_TO_COLOR().value(color));
-    m_tilesWithColor.insert({x, y});
+    run->setColor(x, y, CHAR_TO_COLOR().value(color));
 }
 
-void Window::clearColor(int x, int y) {
+void Window::clearColor(MouseRun* run, int x, int y) {
     if (!isWithinMaze(x, y)) {
         return;
     }
-    m_view->getMazeGraphic()->clearColor(x, y);
-    m_tilesWithColor -= {x, y};
+    run->clearColor(x, y);
 }
 
-void Window::clearAllColor() {
-    for (QPair<int, int> position : m_tilesWithColor) {
-        m_view->getMazeGraphic()->clearColor(position.first, position.second);
-    }
-    m_tilesWithColor.clear();
+void Window::clearAllColor(MouseRun* run) {
+    run->clearAllColor();
 }
 
-void Window::setText(int x, int y, QString text) {
+void Window::setText(MouseRun* run, int x, int y, const QString& text) {
     if (!isWithinMaze(x, y)) {
         return;
     }
-    static QRegExp regex = QRegExp(
-        QString("[^") + FontImage::characters() + QString("]")
-    );
-    text.replace(regex, "?");
-    m_view->getMazeGraphic()->setText(x, y, text);
-    m_tilesWithText.insert({x, y});
+    run->setText(x, y, text);
 }
 
-void Window::clearText(int x, int y) {
+void Window::clearText(MouseRun* run, int x, int y) {
     if (!isWithinMaze(x, y)) {
         return;
     }
-    m_view->getMazeGraphic()->clearText(x, y);
-    m_tilesWithText -= {x, y};
+    run->clearText(x, y);
 }
 
-void Window::clearAllText() {
-    for (QPair<int, int> position : m_tilesWithText) {
-        m_view->getMazeGraphic()->clearText(position.first, position.second);
-    }
-    m_tilesWithText.clear();
+void Window::clearAllText(MouseRun* run) {
+    run->clearAllText();
 }
 
-bool Window::wasReset() {
-    return m_wasReset;
+bool Window::wasReset(MouseRun* run) {
+    return run->wasReset();
 }
 
-void Window::ackReset() {
-    m_mouse->reset();
-    m_startingLocation = {0, 0};
-    m_startingDirection = Direction::NORTH;
-    m_movement = Movement::NONE;
-    m_movementProgress = 0.0;
-    m_movementStepSize = 0.0;
+void Window::ackReset(MouseRun* run) {
+    run->reset();
+
+    // The reset is done once every mouse has been reset
+    for (MouseRun* other : m_runs) {
+        if (other->wasReset()) {
+            return;
+        }
+    }
     m_resetButton->setEnabled(true);
     m_resetButton->setText("Reset");
-    m_wasReset = false;
 }
 
-QString Window::boolToString(bool value) const {
-    return value ? "true" : "false";
+Window::RunMouse::RunMouse(Window* window, MouseRun* run) :
+    m_window(window),
+    m_run(run) {
+}
+
+int Window::RunMouse::mazeWidth() {
+    return m_window->mazeWidth();
+}
+
+int Window::RunMouse::mazeHeight() {
+    return m_window->mazeHeight();
+}
+
+bool Window::RunMouse::wallFront() {
+    return m_window->wallFront(m_run);
+}
+
+bool Window::RunMouse::wallRight() {
+    return m_window->wallRight(m_run);
+}
+
+bool Window::RunMouse::wallLeft() {
+    return m_window->wallLeft(m_run);
+}
+
+QString Window::RunMouse::moveForward() {
+    return m_window->moveForward(m_run);
+}
+
+QString Window::RunMouse::turnRight() {
+    return m_window->turnRight(m_run);
+}
+
+QString Window::RunMouse::turnLeft() {
+    return m_window->turnLeft(m_run);
+}
+
+void Window::RunMouse::setWheelSpeeds(int left, int right) {
+    m_window->setWheelSpeeds(m_run, left, right);
+}
+
+QPair<int, int> Window::RunMouse::readEncoders() {
+    return m_window->readEncoders(m_run);
+}
+
+QVector<double> Window::RunMouse::readSensors() {
+    return m_window->readSensors(m_run);
+}
+
+void Window::RunMouse::setWall(int x, int y, QChar direction) {
+    m_window->setWall(m_run, x, y, direction);
+}
+
+void Window::RunMouse::clearWall(int x, int y, QChar direction) {
+    m_window->clearWall(m_run, x, y, direction);
+}
+
+void Window::RunMouse::setColor(int x, int y, QChar color) {
+    m_window->setColor(m_run, x, y, color);
+}
+
+void Window::RunMouse::clearColor(int x, int y) {
+    m_window->clearColor(m_run, x, y);
+}
+
+void Window::RunMouse::clearAllColor() {
+    m_window->clearAllColor(m_run);
+}
+
+void Window::RunMouse::setText(int x, int y, const QString& text) {
+    m_window->setText(m_run, x, y, text);
+}
+
+void Window::RunMouse::clearText(int x, int y) {
+    m_window->clearText(m_run, x, y);
+}
+
+void Window::RunMouse::clearAllText() {
+    m_window->clearAllText(m_run);
+}
+
+bool Window::RunMouse::wasReset() {
+    return m_window->wasReset(m_run);
+}
+
+void Window::RunMouse::ackReset() {
+    m_window->ackReset(m_run);
+}
+
+QString Window::getAppDataFilePath(QString name) const {
+    QString directory =
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (directory.isEmpty() || !QDir().mkpath(directory)) {
+        return "";
+    }
+    return directory + "/" + name;
 }
 
 bool Window::isWall(Wall wall) const {
-    return m_maze->getTile(wall.x, wall.y)->isWall(wall.d);
+    return m_maze->isWall(wall.x, wall.y, wall.d);
 }
 
 bool Window::isWithinMaze(int x, int y) const {
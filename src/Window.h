@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QByteArray>
 #include <QChar>
 #include <QCloseEvent>
 #include <QComboBox>
@@ -9,26 +10,23 @@
 #include <QPlainTextEdit>
 #include <QProcess>
 #include <QPushButton>
-#include <QQueue>
-#include <QSet>
 #include <QTimer>
 #include <QToolButton>
+#include <QVector>
 
+#include "CommandDispatcher.h"
+#include "CommandParser.h"
+#include "CommandStats.h"
 #include "Map.h"
 #include "Maze.h"
 #include "MazeView.h"
-#include "Mouse.h"
-#include "MouseGraphic.h"
+#include "MouseRun.h"
+#include "RunLog.h"
+#include "RunRecorder.h"
+#include "RunReplay.h"
 
 namespace mms {
 
-enum class Movement {
-    MOVE_FORWARD,
-    TURN_RIGHT,
-    TURN_LEFT,
-    NONE,
-};
-
 struct Wall {
     int x;
     int y;
@@ -87,6 +85,11 @@ private:
     QTabWidget* m_mouseAlgoOutputTabWidget;
     QPlainTextEdit* m_buildOutput;
     QPlainTextEdit* m_runOutput;
+    QPlainTextEdit* m_statsOutput;
+
+    // Lines for the run output, which are shown once per frame
+    RunLog m_runLog;
+    void flushRunLog();
 
     void cancelProcess(QProcess* process, QLabel* status);
     void cancelAllProcesses();
@@ -103,24 +106,36 @@ private:
 
     // ----- Algo run -----
 
+    // The body colors of the mice after the first, which has the configured
+    // body color, in the order that they're added
+    static const QVector<Color> MOUSE_BODY_COLORS;
+
     QPushButton* m_runButton;
-    QProcess* m_runProcess;
+    QPushButton* m_addRunButton;
     QLabel* m_runStatus;
 
+    // Every mouse in the maze, including those whose algorithms have exited,
+    // which stay until the next run; the map shows the view of one of them
+    QVector<MouseRun*> m_runs;
+    int m_shownRun;
+
     void startRun();
+    void addRun();
     void cancelRun();
-    void onRunExit(int exitCode, QProcess::ExitStatus exitStatus);
+    void onRunExit(MouseRun* run, int exitCode, QProcess::ExitStatus exitStatus);
 
-    Mouse* m_mouse;
-    MazeView* m_view;
-    MouseGraphic* m_mouseGraphic;
+    // Starts the named algorithm as another mouse in the maze, returns nullptr
+    // if it couldn't be started
+    MouseRun* startMouseRun(QString name);
+    bool isRunning() const;
 
-    void removeMouseFromMaze();
+    void showNextRun();
+    void updateMapMice();
+    void removeMiceFromMaze();
 
     // ----- Pause/reset ----
 
     bool m_isPaused;
-    bool m_wasReset;
     QPushButton* m_pauseButton;
     QPushButton* m_resetButton;
 
@@ -129,22 +144,86 @@ private:
 
     // ----- Communication -----
 
-    static const QString ACK;
-    static const QString CRASH;
-    static const QString INVALID;
-
-    // Buffers to hold incomplete output, only
-    // process once terminated with a newline
-    QStringList m_logBuffer;
-    QStringList m_commandBuffer;
+    // Output is only processed once it's terminated with a newline
     QStringList processText(QString text, QStringList* buffer);
-
-    QQueue<QString> m_commandQueue;
-    QTimer* m_commandQueueTimer;
-
-    void dispatchCommand(QString command);
-    QString executeCommand(QString command);
-    void processQueuedCommands();
+    void processCommands(MouseRun* run, const QByteArray& output);
+
+    // The runs take turns dispatching their commands, at most
+    // COMMANDS_PER_TURN at a time, so that one algorithm can't starve the
+    // others; after SCHEDULER_SLICE_NANOSECONDS, the rest of the commands wait
+    // for the next iteration of the event loop
+    static const int COMMANDS_PER_TURN;
+    static const qint64 SCHEDULER_SLICE_NANOSECONDS;
+    QTimer* m_schedulerTimer;
+    int m_nextRun;
+    void dispatchPendingCommands();
+    int dispatchCommands(MouseRun* run, int maxCommands);
+
+    // The mouse of a run, as seen by the CommandDispatcher; forwards each
+    // command to the API below
+    class RunMouse : public MouseInterface {
+    public:
+        RunMouse(Window* window, MouseRun* run);
+        int mazeWidth() override;
+        int mazeHeight() override;
+        bool wallFront() override;
+        bool wallRight() override;
+        bool wallLeft() override;
+        QString moveForward() override;
+        QString turnRight() override;
+        QString turnLeft() override;
+        void setWheelSpeeds(int left, int right) override;
+        QPair<int, int> readEncoders() override;
+        QVector<double> readSensors() override;
+        void setWall(int x, int y, QChar direction) override;
+        void clearWall(int x, int y, QChar direction) override;
+        void setColor(int x, int y, QChar color) override;
+        void clearColor(int x, int y) override;
+        void clearAllColor() override;
+        void setText(int x, int y, const QString& text) override;
+        void clearText(int x, int y) override;
+        void clearAllText() override;
+        bool wasReset() override;
+        void ackReset() override;
+    private:
+        Window* m_window;
+        MouseRun* m_run;
+    };
+
+    void dispatchCommand(MouseRun* run, const char* line, int length);
+    QString executeCommand(MouseRun* run, const Command& command);
+    void processQueuedCommands(MouseRun* run);
+
+    // ----- Stats -----
+
+    // Stats of the commands of all runs
+    CommandStats m_commandStats;
+
+    void refreshStats();
+    void writeStats();
+    void writeTrace();
+
+    // ----- Recording -----
+
+    // Every command and response of the first mouse of the current run
+    RunRecorder m_runRecorder;
+    void startRecording();
+    void stopRecording();
+
+    // ----- Replay -----
+
+    static const double MIN_REPLAY_SPEED;
+    static const double MAX_REPLAY_SPEED;
+
+    // Plays back the most recent recording, in place of a run
+    RunReplay* m_replay;
+    QPushButton* m_replayButton;
+    QSlider* m_replaySlider;
+
+    void startReplay();
+    void stopReplay();
+    void advanceReplay(double seconds);
+    void onReplaySliderChanged(int position);
 
     // ----- Movement -----
 
@@ -156,54 +235,58 @@ private:
     static const double MAX_PROGRESS_PER_SECOND;
     static const double MAX_SLEEP_SECONDS;
 
-    // TODO: upforgrabs
-    // Encapsulate this state in the mouse class
-
-    QPair<int, int> m_startingLocation;
-    Direction m_startingDirection;
-    Movement m_movement;
-    double m_movementProgress;
-    double m_movementStepSize;
     QSlider* m_speedSlider;
 
     double progressRequired(Movement movement);
-    void updateMouseProgress(double progress);
-    void scheduleMouseProgressUpdate();
-    bool isMoving();
+    void updateMouseProgress(MouseRun* run, double progress);
+    void scheduleMouseProgressUpdate(MouseRun* run);
+    bool isMoving(MouseRun* run);
+
+    // ----- Continuous simulation -----
+
+    // How much faster than real time that replays and worlds run, according
+    // to the speed slider
+    double getTimeScale() const;
+
+    // Keeps the worlds in step with the speed slider and the pause button, and
+    // moves each mouse to its simulated pose
+    void advanceWorlds();
 
     // ----- API -----
 
     int mazeWidth();
     int mazeHeight();
 
-    bool wallFront();
-    bool wallRight();
-    bool wallLeft();
+    bool wallFront(MouseRun* run);
+    bool wallRight(MouseRun* run);
+    bool wallLeft(MouseRun* run);
 
-    bool moveForward();
-    void turnRight();
-    void turnLeft();
+    // Movements return their response, as described by the MouseInterface
+    QString moveForward(MouseRun* run);
+    QString turnRight(MouseRun* run);
+    QString turnLeft(MouseRun* run);
 
-    void setWall(int x, int y, QChar direction);
-    void clearWall(int x, int y, QChar direction);
+    void setWheelSpeeds(MouseRun* run, int left, int right);
+    QPair<int, int> readEncoders(MouseRun* run);
+    QVector<double> readSensors(MouseRun* run);
 
-    void setColor(int x, int y, QChar color);
-    void clearColor(int x, int y);
-    void clearAllColor();
+    void setWall(MouseRun* run, int x, int y, QChar direction);
+    void clearWall(MouseRun* run, int x, int y, QChar direction);
 
-    void setText(int x, int y, QString text);
-    void clearText(int x, int y);
-    void clearAllText();
+    void setColor(MouseRun* run, int x, int y, QChar color);
+    void clearColor(MouseRun* run, int x, int y);
+    void clearAllColor(MouseRun* run);
 
-    bool wasReset();
-    void ackReset();
+    void setText(MouseRun* run, int x, int y, const QString& text);
+    void clearText(MouseRun* run, int x, int y);
+    void clearAllText(MouseRun* run);
 
-    // ----- Helpers -----
+    bool wasReset(MouseRun* run);
+    void ackReset(MouseRun* run);
 
-    QSet<QPair<int, int>> m_tilesWithColor;
-    QSet<QPair<int, int>> m_tilesWithText;
+    // ----- Helpers -----
 
-    QString boolToString(bool value) const;
+    QString getAppDataFilePath(QString name) const;
     bool isWall(Wall wall) const;
     bool isWithinMaze(int x, int y) const;
     Wall getOpposingWall(Wall wall) const;
@@ -0,0 +1,288 @@
+#include "World.h"
+
+#include <QtMath>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "RayCaster.h"
+#include "SimUtilities.h"
+
+namespace mms {
+
+const double World::STEP_SECONDS = 0.0001;
+const double World::MAX_SPEED = std::numeric_limits<double>::infinity();
+const int World::NUM_SENSORS = 4;
+
+const double World::WHEEL_RADIUS_METERS = 0.02;
+const double World::HALF_TRACK_METERS = 0.03;
+const double World::MAX_WHEEL_RADIANS_PER_SECOND = 20 * M_PI;
+const int World::ENCODER_TICKS_PER_REVOLUTION = 1024;
+const double World::SENSOR_RANGE_METERS = 0.3;
+const double World::SENSOR_HALF_WIDTH_DEGREES = 5.0;
+
+const int World::MAX_STEPS_PER_BATCH = 1000;
+
+World::World(const Maze* maze, const Mouse* mouse) :
+    m_maze(maze),
+    m_initialTranslation(mouse->getInitialTranslation()),
+    m_initialRotation(mouse->getInitialRotation()),
+    m_leftWheel(
+        Distance::Meters(WHEEL_RADIUS_METERS),
+        MAX_WHEEL_RADIANS_PER_SECOND,
+        ENCODER_TICKS_PER_REVOLUTION),
+    m_rightWheel(
+        Distance::Meters(WHEEL_RADIUS_METERS),
+        MAX_WHEEL_RADIANS_PER_SECOND,
+        ENCODER_TICKS_PER_REVOLUTION),
+    m_x(mouse->getCurrentTranslation().getX().getMeters()),
+    m_y(mouse->getCurrentTranslation().getY().getMeters()),
+    m_rotation(mouse->getCurrentRotation().getRadiansUnbounded()),
+    m_isCrashed(false),
+    m_simSeconds(0.0),
+    m_anchorRealSeconds(0.0),
+    m_anchorSimSeconds(0.0),
+    m_speed(1.0),
+    m_isPaused(false),
+    m_isStopping(false) {
+
+    // Bring the body into the frame of the mouse
+    for (const Coordinate& vertex : mouse->getInitialBodyPolygon().getVertices()) {
+        Coordinate relative = Coordinate::Polar(
+            (vertex - m_initialTranslation).getRho(),
+            (vertex - m_initialTranslation).getTheta() - m_initialRotation
+        );
+        m_body.append({
+            relative.getX().getMeters(),
+            relative.getY().getMeters(),
+        });
+    }
+
+    // Two sensors looking to the sides, and two looking straight ahead
+    Angle halfWidth = Angle::Degrees(SENSOR_HALF_WIDTH_DEGREES);
+    Distance range = Distance::Meters(SENSOR_RANGE_METERS);
+    QVector<QPair<Coordinate, Angle>> sensors = {
+        {Coordinate::Cartesian(
+            Distance::Meters(0.03), Distance::Meters(0.02)),
+         Angle::Degrees(90)},
+        {Coordinate::Cartesian(
+            Distance::Meters(0.045), Distance::Meters(0.015)),
+         Angle::Degrees(0)},
+        {Coordinate::Cartesian(
+            Distance::Meters(0.045), Distance::Meters(-0.015)),
+         Angle::Degrees(0)},
+        {Coordinate::Cartesian(
+            Distance::Meters(0.03), Distance::Meters(-0.02)),
+         Angle::Degrees(-90)},
+    };
+    for (const QPair<Coordinate, Angle>& sensor : sensors) {
+        m_sensors.append(Sensor(range, halfWidth, sensor.first, sensor.second));
+    }
+
+    anchor();
+    m_thread = std::thread(&World::run, this);
+}
+
+World::~World() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void World::setSpeed(double speed) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (speed == m_speed) {
+            return;
+        }
+        anchor();
+        m_speed = speed;
+    }
+    m_wake.notify_all();
+}
+
+void World::setPaused(bool isPaused) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (isPaused == m_isPaused) {
+            return;
+        }
+        anchor();
+        m_isPaused = isPaused;
+    }
+    m_wake.notify_all();
+}
+
+void World::reset() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_x = m_initialTranslation.getX().getMeters();
+        m_y = m_initialTranslation.getY().getMeters();
+        m_rotation = m_initialRotation.getRadiansUnbounded();
+        m_isCrashed = false;
+        m_leftWheel.setAngularVelocity(0.0);
+        m_rightWheel.setAngularVelocity(0.0);
+        m_leftWheel.resetEncoder();
+        m_rightWheel.resetEncoder();
+        anchor();
+    }
+    m_wake.notify_all();
+}
+
+void World::setWheelSpeeds(double left, double right) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // While the wheels were stopped, the simulation waited instead of
+        // taking steps that would only have advanced the sim time, so skip
+        // over those steps all at once
+        if (isStopped()) {
+            if (!m_isPaused && !m_isCrashed && m_speed != MAX_SPEED) {
+                m_simSeconds = qMax(m_simSeconds, getDueSimSeconds());
+            }
+            anchor();
+        }
+        m_leftWheel.setAngularVelocity(left);
+        m_rightWheel.setAngularVelocity(right);
+    }
+    m_wake.notify_all();
+}
+
+QPair<int, int> World::readEncoders() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return {m_leftWheel.readEncoder(), m_rightWheel.readEncoder()};
+}
+
+QVector<double> World::readSensors() const {
+
+    // The rays are cast outside of the lock, so that the simulation doesn't
+    // wait on them, and all at once
+    QVector<RayCaster::Ray> rays;
+    rays.reserve(m_sensors.size() * Sensor::NUM_EDGE_POINTS);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Sensor& sensor : m_sensors) {
+            sensor.appendRays(m_x, m_y, m_rotation, &rays);
+        }
+    }
+    QVector<double> distances = RayCaster::cast(m_maze->getWallGrid(), rays);
+    QVector<double> readings;
+    for (int i = 0; i < m_sensors.size(); i += 1) {
+        readings.append(m_sensors.at(i).read(
+            distances.constData() + i * Sensor::NUM_EDGE_POINTS));
+    }
+    return readings;
+}
+
+void World::getPose(Coordinate* translation, Angle* rotation) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    *translation = Coordinate::Cartesian(
+        Distance::Meters(m_x),
+        Distance::Meters(m_y)
+    );
+    *rotation = Angle::Radians(m_rotation);
+}
+
+bool World::isCrashed() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isCrashed;
+}
+
+double World::getSimSeconds() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_simSeconds;
+}
+
+void World::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_isStopping) {
+        // Nothing moves while the wheels are stopped, so there's nothing to
+        // simulate until they're set in motion
+        if (m_isPaused || m_isCrashed || isStopped()) {
+            m_wake.wait(lock);
+            continue;
+        }
+
+        // Take as many steps as are due, or a whole batch at max speed
+        int steps = MAX_STEPS_PER_BATCH;
+        if (m_speed != MAX_SPEED) {
+            double stepsDue =
+                (getDueSimSeconds() - m_simSeconds) / STEP_SECONDS;
+            if (stepsDue < 1.0) {
+                m_wake.wait_for(
+                    lock,
+                    std::chrono::duration<double>(
+                        (1.0 - stepsDue) * STEP_SECONDS / m_speed
+                    )
+                );
+                continue;
+            }
+            steps = qMin(steps, static_cast<int>(stepsDue));
+        }
+        for (int i = 0; i < steps && !m_isCrashed; i += 1) {
+            step();
+        }
+
+        // Give the readers a chance to sample the state
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+    }
+}
+
+void World::step() {
+
+    // How far each wheel turns during the step
+    double left = m_leftWheel.getAngularVelocity() * STEP_SECONDS;
+    double right = m_rightWheel.getAngularVelocity() * STEP_SECONDS;
+    m_leftWheel.updateRotation(left);
+    m_rightWheel.updateRotation(right);
+    m_simSeconds += STEP_SECONDS;
+    if (left == 0.0 && right == 0.0) {
+        return;
+    }
+
+    // Differential drive, moving along the heading at the middle of the step
+    double forward = WHEEL_RADIUS_METERS * (left + right) / 2.0;
+    double turn =
+        WHEEL_RADIUS_METERS * (right - left) / (2.0 * HALF_TRACK_METERS);
+    double heading = m_rotation + turn / 2.0;
+    CollisionDetector::Pose from = {m_x, m_y, m_rotation};
+    CollisionDetector::Pose to = {
+        m_x + forward * std::cos(heading),
+        m_y + forward * std::sin(heading),
+        m_rotation + turn,
+    };
+
+    // The mouse stops right where it hits a wall
+    double fraction = 0.0;
+    if (CollisionDetector::findImpact(
+            m_maze->getWallGrid(), m_body, from, to, &fraction)) {
+        to = CollisionDetector::interpolate(from, to, fraction);
+        m_isCrashed = true;
+    }
+    m_x = to.x;
+    m_y = to.y;
+    m_rotation = to.rotation;
+}
+
+bool World::isStopped() const {
+    return m_leftWheel.getAngularVelocity() == 0.0 &&
+        m_rightWheel.getAngularVelocity() == 0.0;
+}
+
+double World::getDueSimSeconds() const {
+    return m_anchorSimSeconds +
+        (SimUtilities::getHighResTimestamp() - m_anchorRealSeconds) * m_speed;
+}
+
+void World::anchor() {
+    m_anchorRealSeconds = SimUtilities::getHighResTimestamp();
+    m_anchorSimSeconds = m_simSeconds;
+}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QPair>
+#include <QVector>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "units/Angle.h"
+#include "units/Coordinate.h"
+
+#include "CollisionDetector.h"
+#include "Maze.h"
+#include "Mouse.h"
+#include "Sensor.h"
+#include "Wheel.h"
+
+namespace mms {
+
+// The continuous simulation of a mouse, ported from the old simulator: its
+// wheels move it around the maze, and its sensors see the walls. It advances
+// in fixed steps of sim time, on a thread of its own, keeping pace with real
+// time (scaled by the speed) or, at MAX_SPEED, running as fast as it can.
+// Everything else just samples its state, so the public functions are all
+// thread safe.
+class World {
+
+public:
+
+    static const double STEP_SECONDS;
+    static const double MAX_SPEED;
+    static const int NUM_SENSORS;
+
+    // The shape comes from the mouse, and the simulation starts wherever the
+    // mouse is now; the mouse isn't modified
+    World(const Maze* maze, const Mouse* mouse);
+    ~World();
+
+    // Changing the pace doesn't make up for lost time, or skip ahead
+    void setSpeed(double speed);
+    void setPaused(bool isPaused);
+
+    // Puts the mouse back at the start, with its wheels stopped and its
+    // encoders reset
+    void reset();
+
+    // Wheel speeds are in radians per second, capped at the max speed of the
+    // wheels; encoders are read in ticks, and sensors from 0.0 to 1.0
+    void setWheelSpeeds(double left, double right);
+    QPair<int, int> readEncoders() const;
+    QVector<double> readSensors() const;
+
+    void getPose(Coordinate* translation, Angle* rotation) const;
+    bool isCrashed() const;
+    double getSimSeconds() const;
+
+private:
+
+    // The mouse
+    static const double WHEEL_RADIUS_METERS;
+    static const double HALF_TRACK_METERS;
+    static const double MAX_WHEEL_RADIANS_PER_SECOND;
+    static const int ENCODER_TICKS_PER_REVOLUTION;
+    static const double SENSOR_RANGE_METERS;
+    static const double SENSOR_HALF_WIDTH_DEGREES;
+
+    // The most steps taken at once, after which waiting readers get a turn
+    static const int MAX_STEPS_PER_BATCH;
+
+    const Maze* m_maze;
+    Coordinate m_initialTranslation;
+    Angle m_initialRotation;
+
+    // Relative to the center of the mouse, with the mouse facing along the
+    // x axis, like the positions of the sensors
+    QVector<CollisionDetector::Point> m_body;
+
+    // Everything below is guarded by the mutex
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+
+    Wheel m_leftWheel;
+    Wheel m_rightWheel;
+    QVector<Sensor> m_sensors;
+
+    // The pose of the mouse, in meters and radians
+    double m_x;
+    double m_y;
+    double m_rotation;
+    bool m_isCrashed;
+
+    // The sim time, and the real and sim times when the pace last changed
+    double m_simSeconds;
+    double m_anchorRealSeconds;
+    double m_anchorSimSeconds;
+    double m_speed;
+    bool m_isPaused;
+    bool m_isStopping;
+
+    std::thread m_thread;
+
+    void run();
+    void step();
+
+    // Whether both wheels are stopped, in which case the thread sleeps
+    bool isStopped() const;
+
+    // The sim time that's due according to the real time since the anchor
+    double getDueSimSeconds() const;
+    void anchor();
+
+};
+
+}